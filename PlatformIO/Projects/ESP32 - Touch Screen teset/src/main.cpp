@@ -1,29 +1,24 @@
 #include <Adafruit_GFX.h>
-#include <Adafruit_ILI9341.h>
-#include <SPI.h>
-#include <XPT2046_Touchscreen.h> 
+#include <TFTDisplay.h>
+#include <TFTTouch.h>
+#include <TouchUI.h>
+#include <UIDisplayTarget.h>
+#include <Logger.h>
 
 // --- PIN DEFINITIONS ---
-// Display Pins
-#define TFT_CS    10
-#define TFT_DC    8
-#define TFT_RST   4
-#define TFT_MOSI  11 
-#define TFT_SCK   12 
+// Display Pins: TFT_CS/DC/RST/MOSI/SCK from TFTPins.h
 
 // Touch Pins
-#define T_CS      5     
+#define T_CS      5
 #define T_MISO    9     // <--- NEW MISO PIN: GPIO 9
-#define T_IRQ     7     
+#define T_IRQ     7
 
-// Define the SPI Settings used by the ILI9341 display
-SPISettings settingsA(40000000, MSBFIRST, SPI_MODE0); 
+// Initialize the display; the touch controller reads back over MISO, so
+// the shared bus is brought up with it
+TFTDisplay tft(TFT_CS, TFT_DC, TFT_RST, TFT_MOSI, TFT_SCK, T_MISO);
 
-// Initialize the display
-Adafruit_ILI9341 tft = Adafruit_ILI9341(TFT_CS, TFT_DC, TFT_MOSI, TFT_SCK, TFT_RST);
-
-// Initialize the touch controller
-XPT2046_Touchscreen ts(T_CS, T_IRQ);
+// Initialize the touch controller (second device on the display's bus)
+TFTTouch ts(tft, T_CS, T_IRQ);
 
 // --- CALIBRATION VALUES (Landscape Mode: Rotation 1) ---
 #define TS_MINX 120
@@ -32,69 +27,123 @@ XPT2046_Touchscreen ts(T_CS, T_IRQ);
 #define TS_MAXY 900
 #define MIN_PRESSURE 1 // Low pressure for debugging
 
+// --- TOUCH TRAIL WIDGET ---
+// Keeps the last touch points so they can be repainted after anything
+// drawn over them changes, instead of being painted once and forgotten.
+#define TRAIL_POINTS 128
+#define DOT_RADIUS   5
+
+class TouchTrail : public ui::Widget {
+public:
+  explicit TouchTrail(const ui::Rect& bounds) : ui::Widget(bounds), head(0), count(0) {
+    _touchable = true;
+  }
+
+  void add(int16_t x, int16_t y) {
+    // Drop the oldest dot once full, and repaint where it was
+    if (count == TRAIL_POINTS) invalidate(dotRect(xs[head], ys[head]));
+    else count++;
+    xs[head] = x;
+    ys[head] = y;
+    head = (head + 1) % TRAIL_POINTS;
+    invalidate(dotRect(x, y));
+  }
+
+  void clear() {
+    head = 0;
+    count = 0;
+    invalidate();
+  }
+
+  void draw(Adafruit_GFX& g, const ui::Rect& clip) override {
+    for (uint8_t i = 0; i < count; i++) {
+      if (dotRect(xs[i], ys[i]).intersects(clip)) g.fillCircle(xs[i], ys[i], DOT_RADIUS, ILI9341_MAGENTA);
+    }
+  }
+
+  void onTouch(const ui::TouchEvent& ev) override {
+    if (ev.type != ui::TouchEvent::UP) add(ev.x, ev.y);
+  }
+
+private:
+  static ui::Rect dotRect(int16_t x, int16_t y) {
+    return ui::Rect(x - DOT_RADIUS, y - DOT_RADIUS, 2 * DOT_RADIUS + 1, 2 * DOT_RADIUS + 1);
+  }
+
+  int16_t xs[TRAIL_POINTS];
+  int16_t ys[TRAIL_POINTS];
+  uint8_t head;
+  uint8_t count;
+};
+
+// --- UI ---
+ui::DisplayTarget uiTarget(tft);
+ui::Compositor compositor(uiTarget);
+ui::Screen home(ILI9341_BLACK);
+
+TouchTrail trail(ui::Rect(0, 0, 320, 240));
+ui::Label title(ui::Rect(10, 10, 300, 16), "Touch Panel Active!", ILI9341_GREEN);
+ui::Label hint(ui::Rect(10, 40, 300, 8), "Touch for Raw Data (GPIO 9).", ILI9341_GREEN);
+ui::Label rawData(ui::Rect(10, 56, 300, 8), "", ILI9341_WHITE);
+ui::Label footer(ui::Rect(10, 225, 200, 8), "Press BOOT to clear screen.", ILI9341_GREEN);
+ui::Button clearButton(ui::Rect(240, 205, 70, 28), "CLEAR", [](ui::Button&) { trail.clear(); });
+
 void setup() {
   Serial.begin(115200);
-  Serial.println("--- System Initialized. Testing GPIO 9 MISO ---"); 
-  
-  // 1. Initialize SPI Bus with all pins explicitly defined
-  // SCK=12, MISO=9, MOSI=11, CS=10
-  SPI.begin(TFT_SCK, T_MISO, TFT_MOSI, TFT_CS); 
-  
-  // 2. Initialize Display with SPI Transaction Control
-  SPI.beginTransaction(settingsA); 
+  logger::begin(Serial);
+  LOG_INFO("--- System Initialized. Testing GPIO 9 MISO ---");
+
+  // 1. Initialize Display (brings up the SPI bus: SCK=12, MISO=9, MOSI=11, CS=10)
   tft.begin();
-  tft.setRotation(1); 
-  tft.fillScreen(ILI9341_BLACK); 
-  SPI.endTransaction();
-  
-  // 3. Initialize Touch
-  ts.begin(); 
-  ts.setRotation(1); 
-
-  // Draw instructions
-  tft.setTextColor(ILI9341_GREEN);
-  tft.setTextSize(2);
-  tft.setCursor(10, 10);
-  tft.println("Touch Panel Active!");
-  tft.setTextSize(1);
-  tft.setCursor(10, 40);
-  tft.println("Touch for Raw Data (GPIO 9).");
-  tft.setCursor(10, tft.height() - 15);
-  tft.println("Press BOOT to clear screen.");
+  tft.setRotation(1);
+  tft.fillScreen(ILI9341_BLACK);
+
+  // 2. Initialize Touch
+  ts.begin();
+  ts.setRotation(1);
+
+  // 3. Build the screen; the trail goes first so text and the button sit on top
+  title.setTextSize(2);
+  home.add(trail);
+  home.add(title);
+  home.add(hint);
+  home.add(rawData);
+  home.add(footer);
+  home.add(clearButton);
+  compositor.show(home);
 }
 
 void loop() {
   // Check both touch detection methods: the interrupt pin and simple polling
+  bool pressed = false;
+  int x = 0, y = 0;
+
   if (ts.tirqTouched() || ts.touched()) {
-    TS_Point p = ts.getPoint();
-    
+    TouchPoint p = ts.getPoint();
+
     if (p.z > MIN_PRESSURE) {
-      
+      pressed = true;
+
       // Map the raw touch point to the screen resolution
-      int x = map(p.y, TS_MINY, TS_MAXY, tft.width(), 0);
-      int y = map(p.x, TS_MINX, TS_MAXX, tft.height(), 0);
-      
-      tft.fillCircle(x, y, 5, ILI9341_MAGENTA);
-      
-      // Print raw data 
-      Serial.print("Raw X="); Serial.print(p.x);
-      Serial.print("\tRaw Y="); Serial.print(p.y);
-      Serial.print("\tPressure Z="); Serial.println(p.z); 
+      x = map(p.y, TS_MINY, TS_MAXY, tft.width(), 0);
+      y = map(p.x, TS_MINX, TS_MAXX, tft.height(), 0);
+
+      // Print raw data
+      char raw[40];
+      snprintf(raw, sizeof(raw), "Raw X=%d  Y=%d  Z=%d", p.x, p.y, p.z);
+      rawData.setText(raw);
+
+      LOG_INFO("Raw X=%d\tRaw Y=%d\tPressure Z=%d", p.x, p.y, p.z);
     }
   }
+  compositor.touch(pressed, x, y);
 
-  // Clear screen using the BOOT button (GPIO 0)
+  // Clear the dots using the BOOT button (GPIO 0); the text is retained
   if (digitalRead(0) == LOW) {
-    tft.fillScreen(ILI9341_BLACK); 
-    tft.setTextColor(ILI9341_GREEN);
-    tft.setTextSize(2);
-    tft.setCursor(10, 10);
-    tft.println("Touch Panel Active!");
-    tft.setTextSize(1);
-    tft.setCursor(10, 40);
-    tft.println("Touch for Raw Data (GPIO 9).");
-    tft.setCursor(10, tft.height() - 15);
-    tft.println("Press BOOT to clear screen.");
-    delay(500); 
+    trail.clear();
+    delay(500);
   }
-}
\ No newline at end of file
+
+  // Repaint only what changed since the last pass
+  compositor.update();
+}
@@ -1,15 +1,8 @@
 #include <Adafruit_GFX.h>
-#include <Adafruit_ILI9341.h>
-#include <SPI.h>
+#include <TFTDisplay.h>    // Shared DMA display driver (pins in TFTPins.h)
 #include <WiFi.h>          // ESP32 Wi-Fi library
 #include <NTPClient.h>     // Requires NTPClient library installed
-
-// --- CONFIGURATION PINS (Left Header) ---
-#define TFT_CS    10
-#define TFT_DC    8
-#define TFT_RST   4
-#define TFT_MOSI  11
-#define TFT_SCK   12
+#include <Logger.h>        // Buffered serial logging (PlatformIO/lib/Logger)
 
 // --- WIFI CONFIGURATION ---
 const char *ssid     = "";   // <--- CHANGE THIS
@@ -28,10 +21,11 @@ WiFiUDP ntpUDP;
 NTPClient timeClient(ntpUDP, "pool.ntp.org", utcOffsetInSeconds);
 
 // Initialize the display
-Adafruit_ILI9341 tft = Adafruit_ILI9341(TFT_CS, TFT_DC, TFT_MOSI, TFT_SCK, TFT_RST);
+TFTDisplay tft;
 
 void setup() {
   Serial.begin(115200);
+  logger::begin(Serial);
 
   // 1. Initialize Display
   tft.begin();
@@ -48,7 +42,6 @@ void setup() {
   int attempts = 0;
   while (WiFi.status() != WL_CONNECTED && attempts < 20) {
     delay(500);
-    Serial.print(".");
     attempts++;
   }
 
@@ -58,9 +51,7 @@ void setup() {
     tft.setCursor(10, 10);
     tft.setTextColor(ILI9341_GREEN);
     tft.println("WiFi Connected!");
-    Serial.println("\nWiFi Connected.");
-    Serial.print("IP Address: ");
-    Serial.println(WiFi.localIP());
+    LOG_INFO("WiFi Connected after %d ms. IP Address: %s", attempts * 500, WiFi.localIP().toString().c_str());
     
     // 4. Initialize and update NTP client
     timeClient.begin();
@@ -71,6 +62,7 @@ void setup() {
     tft.setCursor(10, 40);
     tft.setTextColor(ILI9341_RED);
     tft.println("WiFi Failed!");
+    LOG_WARN("WiFi Failed after %d ms", attempts * 500);
   }
 }
 
@@ -94,7 +86,7 @@ void loop() {
     // Print the time
     tft.print(formattedTime);
     
-    Serial.println(formattedTime);
+    LOG_INFO("%s", formattedTime.c_str());
   }
 
   // Wait 1 second before updating the display again
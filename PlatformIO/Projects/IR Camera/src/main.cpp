@@ -1,17 +1,17 @@
+#include "secrets.h"
 #include <Arduino.h>
 #include <Wire.h>
+#include <WiFi.h>
 #include <Adafruit_GFX.h>
-#include <Adafruit_ILI9341.h>
 #include <Adafruit_MLX90640.h>
-#include <SPI.h>
+#include <TFTDisplay.h>
+#include <Telemetry.h>
+#include <Hotspots.h>
+#include <IRStream.h>
+#include <Logger.h>
 
 // --- PIN DEFINITIONS ---
-// Display Pins (Same as your working weather station)
-#define TFT_CS    10
-#define TFT_DC    8
-#define TFT_RST   4
-#define TFT_MOSI  11
-#define TFT_SCK   12
+// Display pins come from TFTPins.h (shared by all projects)
 
 // IR Sensor Pins (I2C)
 #define I2C_SDA   16
@@ -24,9 +24,22 @@
 // Scale factor: 32x24 sensor -> 320x240 screen (Scale = 10)
 #define PIXEL_SCALE 10 
 
+// Sensor rows per DMA strip: 2 rows x 10 lines x 320 px fits one line buffer
+#define ROWS_PER_STRIP 2
+static_assert(ROWS_PER_STRIP * PIXEL_SCALE * 320 <= TFT_LINE_BUFFER_PIXELS,
+              "a strip must fit one TFTDisplay line buffer");
+
+// Hotspot analytics (degrees C): pixels at or above HOTSPOT_THRESHOLD form
+// tracked regions; a region peaking at or above HOTSPOT_ALARM is drawn red
+// and logged when it first crosses
+#define HOTSPOT_THRESHOLD 28.0
+#define HOTSPOT_ALARM     35.0
+
+// Serial TX buffer, large enough to take a telemetry record without blocking
+#define SERIAL_TX_BUFFER 1024
+
 // Display Settings
-Adafruit_ILI9341 tft = Adafruit_ILI9341(TFT_CS, TFT_DC, TFT_MOSI, TFT_SCK, TFT_RST);
-SPISettings settingsA(40000000, MSBFIRST, SPI_MODE0);
+TFTDisplay tft;
 
 // Sensor Object
 Adafruit_MLX90640 mlx;
@@ -38,18 +51,45 @@ float frame[32 * 24];
 float minTemp = 20.0;
 float maxTemp = 40.0;
 
+// Hot regions found in the current frame (hottest first)
+hotspots::Tracker hotspotTracker;
+uint8_t hotspotCount = 0;
+bool alarmActive = false;
+
+// "ip:port" viewers connect to, shown on the status line; empty when not
+// streaming
+String streamAddress;
+
+// Per-stage timing, exported over Serial every 2 s (decode with
+// tools/telemetry_decode.py). Colormap and push are timed per strip; push
+// is the time spent waiting for the previous strip's DMA to drain.
+const uint8_t STAGE_CAPTURE  = telemetry::addStage("capture");
+const uint8_t STAGE_STREAM   = telemetry::addStage("stream");
+const uint8_t STAGE_STATS    = telemetry::addStage("stats");
+const uint8_t STAGE_HOTSPOTS = telemetry::addStage("hotspots");
+const uint8_t STAGE_COLORMAP = telemetry::addStage("colormap");
+const uint8_t STAGE_PUSH     = telemetry::addStage("spi push");
+const uint8_t STAGE_OVERLAY  = telemetry::addStage("overlay");
+const uint8_t STAGE_RENDER   = telemetry::addStage("render");
+
 // Function Prototypes
 void initializeDisplay();
 void initializeSensor();
+void connectWiFi();
 uint16_t mapTempToColor(float val, float minVal, float maxVal);
+void drawStrip(uint16_t* strip, uint8_t firstRow);
 void drawInterface();
+void drawHotspots();
+void checkAlarm();
 
 // -------------------------------------------------------------------
 // SETUP
 // -------------------------------------------------------------------
 void setup() {
+  Serial.setTxBufferSize(SERIAL_TX_BUFFER);
   Serial.begin(115200);
-  
+  logger::begin(Serial);
+
   // 1. Initialize Display
   initializeDisplay();
   tft.println("Initializing IR...");
@@ -57,6 +97,9 @@ void setup() {
   // 2. Initialize Sensor
   initializeSensor();
 
+  // 3. Join Wi-Fi and serve frames (the camera works without it)
+  connectWiFi();
+
   tft.fillScreen(ILI9341_BLACK);
 }
 
@@ -66,50 +109,74 @@ void setup() {
 void loop() {
   // 1. Capture Data from MLX90640
   // getFrame returns 0 on success
-  if (mlx.getFrame(frame) != 0) {
-    Serial.println("Failed to read from sensor");
+  int status;
+  {
+    TELEMETRY_SCOPE(STAGE_CAPTURE);
+    status = mlx.getFrame(frame);
+  }
+  if (status != 0) {
+    LOG_WARN("Failed to read from sensor (status %d)", status);
     return;
   }
 
-  // 2. Find Min/Max Temp in the current frame for Auto-Scaling
-  minTemp = 1000.0; // Start high
-  maxTemp = -1000.0; // Start low
-
-  for (int i = 0; i < 768; i++) {
-    float t = frame[i];
-    if (t < minTemp) minTemp = t;
-    if (t > maxTemp) maxTemp = t;
+  // Hand the frame to the streaming task straight away (never blocks;
+  // viewers that are behind skip frames)
+  {
+    TELEMETRY_SCOPE(STAGE_STREAM);
+    irstream::publish(frame);
   }
 
-  // Add a small buffer to prevent flickering if min == max
-  if ((maxTemp - minTemp) < 1.0) maxTemp = minTemp + 1.0;
+  // Everything below this point is the render time for the frame
+  TELEMETRY_SCOPE(STAGE_RENDER);
 
-  // 3. Draw the Thermal Image
-  SPI.beginTransaction(settingsA);
-  
-  // Iterate through 24 rows and 32 columns
-  for (uint8_t h = 0; h < 24; h++) {
-    for (uint8_t w = 0; w < 32; w++) {
-      // Calculate index in the 1D array
-      // NOTE: Depending on how you mounted the sensor, you might need to flip these logic
-      // Standard: index = h * 32 + w
-      float t = frame[h * 32 + w]; 
+  // 2. Find Min/Max Temp in the current frame for Auto-Scaling
+  {
+    TELEMETRY_SCOPE(STAGE_STATS);
+    minTemp = 1000.0; // Start high
+    maxTemp = -1000.0; // Start low
+
+    for (int i = 0; i < 768; i++) {
+      float t = frame[i];
+      if (t < minTemp) minTemp = t;
+      if (t > maxTemp) maxTemp = t;
+    }
 
-      // Get Color
-      uint16_t color = mapTempToColor(t, minTemp, maxTemp);
+    // Add a small buffer to prevent flickering if min == max
+    if ((maxTemp - minTemp) < 1.0) maxTemp = minTemp + 1.0;
+  }
 
-      // Draw 'Big Pixel' (10x10 rectangle)
-      // x = w * 10, y = h * 10
-      tft.fillRect(w * PIXEL_SCALE, h * PIXEL_SCALE, PIXEL_SCALE, PIXEL_SCALE, color);
+  // 3. Label and track hot regions
+  {
+    TELEMETRY_SCOPE(STAGE_HOTSPOTS);
+    hotspotCount = hotspotTracker.update(frame, HOTSPOT_THRESHOLD);
+  }
+  checkAlarm();
+
+  // 4. Draw the Thermal Image
+  // Each strip of sensor rows is colormapped into one line buffer and queued
+  // for DMA; the next strip is built while the previous one is on the wire.
+  for (uint8_t h = 0; h < 24; h += ROWS_PER_STRIP) {
+    uint16_t* strip = tft.lineBuffer();
+    {
+      TELEMETRY_SCOPE(STAGE_COLORMAP);
+      drawStrip(strip, h);
     }
+    TELEMETRY_SCOPE(STAGE_PUSH);
+    tft.pushStrip(h * PIXEL_SCALE, ROWS_PER_STRIP * PIXEL_SCALE, strip);
   }
 
-  // 4. Draw Overlay Information (Center Temp, Min/Max)
+  // 5. Draw Overlay Information (Hotspots, Center Temp, Min/Max)
   // We draw this AFTER the image so it sits on top
-  drawInterface();
-  
-  SPI.endTransaction();
-  
+  {
+    TELEMETRY_SCOPE(STAGE_OVERLAY);
+    drawHotspots();
+    drawInterface();
+  }
+
+  // Ship the stage histograms when a window is complete (never blocks;
+  // goes through the logger, which shares Serial)
+  telemetry::exportIfDue(logger::writeIfRoom);
+
   // No delay needed; the sensor read takes time naturally (~250ms at 4Hz)
 }
 
@@ -118,15 +185,12 @@ void loop() {
 // -------------------------------------------------------------------
 
 void initializeDisplay() {
-  SPI.begin();
-  SPI.beginTransaction(settingsA); 
   tft.begin();
   tft.setRotation(1); // Landscape
   tft.fillScreen(ILI9341_BLACK); 
   tft.setTextColor(ILI9341_WHITE);
   tft.setTextSize(2);
   tft.setCursor(10, 10);
-  SPI.endTransaction();
 }
 
 void initializeSensor() {
@@ -135,7 +199,7 @@ void initializeSensor() {
   Wire.setClock(400000); // 400 KHz I2C speed
 
   if (!mlx.begin(MLX90640_I2C_ADDR, &Wire)) {
-    Serial.println("MLX90640 not found!");
+    LOG_ERROR("MLX90640 not found!");
     tft.fillScreen(ILI9341_RED);
     tft.setCursor(10, 10);
     tft.println("Sensor Error!");
@@ -145,7 +209,7 @@ void initializeSensor() {
     while (1);
   }
 
-  Serial.println("MLX90640 Found!");
+  LOG_INFO("MLX90640 Found!");
   
   // FIX 1: Correct Refresh Rate Syntax
   mlx.setRefreshRate(MLX90640_4_HZ); 
@@ -154,6 +218,32 @@ void initializeSensor() {
   mlx.setMode(MLX90640_INTERLEAVED); 
 }
 
+void connectWiFi() {
+  if (WIFI_SSID[0] == '\0') {
+    LOG_WARN("No WiFi configured in secrets.h, running without streaming");
+    return;
+  }
+
+  WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
+  int attempts = 0;
+  while (WiFi.status() != WL_CONNECTED && attempts < 20) {
+    delay(500);
+    attempts++;
+  }
+
+  if (WiFi.status() != WL_CONNECTED) {
+    LOG_WARN("WiFi Failed! Running without streaming");
+    return;
+  }
+  if (!irstream::begin(IRSTREAM_PORT)) {
+    LOG_ERROR("Stream server failed to start");
+    return;
+  }
+
+  streamAddress = WiFi.localIP().toString() + ":" + String(irstream::port());
+  LOG_INFO("Streaming on %s", streamAddress.c_str());
+}
+
 // Map temperature to a simple heatmap (Blue -> Green -> Red)
 uint16_t mapTempToColor(float val, float minVal, float maxVal) {
   // Constrain value
@@ -181,6 +271,31 @@ uint16_t mapTempToColor(float val, float minVal, float maxVal) {
   return tft.color565(r, g, b);
 }
 
+// Fill ROWS_PER_STRIP sensor rows as 'Big Pixels' (10x10 blocks) into a
+// 320-wide strip, in the byte order the panel expects
+void drawStrip(uint16_t* strip, uint8_t firstRow) {
+  uint16_t colors[32];
+
+  for (uint8_t h = firstRow; h < firstRow + ROWS_PER_STRIP; h++) {
+    // Calculate index in the 1D array
+    // NOTE: Depending on how you mounted the sensor, you might need to flip these logic
+    // Standard: index = h * 32 + w
+    for (uint8_t w = 0; w < 32; w++) {
+      colors[w] = TFTDisplay::swap565(mapTempToColor(frame[h * 32 + w], minTemp, maxTemp));
+    }
+
+    // Build the first line of the block row, then repeat it PIXEL_SCALE times
+    uint16_t* line = strip;
+    for (uint8_t w = 0; w < 32; w++) {
+      for (uint8_t i = 0; i < PIXEL_SCALE; i++) *line++ = colors[w];
+    }
+    for (uint8_t i = 1; i < PIXEL_SCALE; i++) {
+      memcpy(strip + i * 32 * PIXEL_SCALE, strip, 32 * PIXEL_SCALE * sizeof(uint16_t));
+    }
+    strip += PIXEL_SCALE * 32 * PIXEL_SCALE;
+  }
+}
+
 void drawInterface() {
   // Draw Crosshair in center
   int centerX = tft.width() / 2;
@@ -208,4 +323,58 @@ void drawInterface() {
   
   tft.setCursor(240, 220);
   tft.print("Max: "); tft.print(maxTemp, 0);
-}
\ No newline at end of file
+
+  // Where to watch from, between the two
+  if (streamAddress.length()) {
+    tft.setCursor(160 - streamAddress.length() * 3, 220);
+    tft.print(streamAddress);
+  }
+}
+
+// Box and label every tracked region; alarm-level ones in red
+void drawHotspots() {
+  tft.setTextSize(1);
+
+  for (uint8_t i = 0; i < hotspotCount; i++) {
+    const hotspots::Blob& b = hotspotTracker[i];
+    uint16_t color = b.peak >= HOTSPOT_ALARM ? ILI9341_RED : ILI9341_WHITE;
+
+    int x = b.x0 * PIXEL_SCALE;
+    int y = b.y0 * PIXEL_SCALE;
+    int w = (b.x1 - b.x0 + 1) * PIXEL_SCALE;
+    int h = (b.y1 - b.y0 + 1) * PIXEL_SCALE;
+    tft.drawRect(x, y, w, h, color);
+
+    // Label above the box, or inside it on the top row
+    tft.setTextColor(color, ILI9341_BLACK);
+    tft.setCursor(x + 1, y >= 9 ? y - 9 : y + 2);
+    tft.print('#'); tft.print(b.id);
+    tft.print(' '); tft.print(b.peak, 1);
+  }
+
+  // Thresholds in use, and the alarm state
+  tft.setTextColor(ILI9341_WHITE, ILI9341_BLACK);
+  tft.setCursor(5, 230);
+  tft.print("Hot>"); tft.print(HOTSPOT_THRESHOLD, 0);
+  tft.print(" Alarm>"); tft.print(HOTSPOT_ALARM, 0);
+
+  if (alarmActive) {
+    tft.setTextColor(ILI9341_WHITE, ILI9341_RED);
+    tft.setCursor(240, 230);
+    tft.print(" ALARM ");
+  }
+}
+
+// The hottest region is first, so it alone decides the alarm; log only
+// when the state changes
+void checkAlarm() {
+  bool alarm = hotspotCount > 0 && hotspotTracker[0].peak >= HOTSPOT_ALARM;
+  if (alarm && !alarmActive) {
+    const hotspots::Blob& b = hotspotTracker[0];
+    LOG_WARN("Hotspot #%u alarm: %.1fC peak, %u px at (%.1f, %.1f)",
+             b.id, b.peak, b.area, b.cx, b.cy);
+  } else if (!alarm && alarmActive) {
+    LOG_INFO("Hotspot alarm cleared");
+  }
+  alarmActive = alarm;
+}
@@ -0,0 +1,13 @@
+// -------------------------------------------------------------------
+// WiFi Configuration (frames are streamed to tools/irstream_client.py)
+// -------------------------------------------------------------------
+
+// Replace with your network credentials (leave the SSID empty to run
+// without streaming)
+#ifndef WIFI_SSID
+#define WIFI_SSID       ""
+#endif
+#ifndef WIFI_PASSWORD
+#define WIFI_PASSWORD   ""
+#endif
+// -------------------------------------------------------------------
@@ -0,0 +1,360 @@
+// Hot-region labelling and tracking, on the host:
+//
+//   pio test -e native -f test_hotspots
+
+#include <Hotspots.h>
+#include <algorithm>
+#include <math.h>
+#include <tuple>
+#include <unity.h>
+#include <vector>
+
+#define W HOTSPOTS_WIDTH
+#define H HOTSPOTS_HEIGHT
+
+static const float COLD = 20.0f;
+static const float THRESHOLD = 30.0f;
+
+static float frame[W * H];
+static hotspots::Tracker tracker;
+
+static void set(int x, int y, float t = 35.0f) {
+  frame[y * W + x] = t;
+}
+
+static void assertBox(const hotspots::Blob& b, int x0, int y0, int x1, int y1) {
+  TEST_ASSERT_EQUAL(x0, b.x0);
+  TEST_ASSERT_EQUAL(y0, b.y0);
+  TEST_ASSERT_EQUAL(x1, b.x1);
+  TEST_ASSERT_EQUAL(y1, b.y1);
+}
+
+// 2x2 hot square with its top-left corner at (x, y)
+static void square(int x, int y, float t = 35.0f) {
+  for (int dy = 0; dy < 2; dy++)
+    for (int dx = 0; dx < 2; dx++) set(x + dx, y + dy, t);
+}
+
+static void clear() {
+  std::fill(frame, frame + W * H, COLD);
+}
+
+void setUp() {
+  clear();
+  tracker.reset();
+}
+
+void tearDown() {}
+
+// -------------------------------------------------------------------
+// CONNECTIVITY
+// -------------------------------------------------------------------
+
+void test_separate_regions() {
+  for (int y = 2; y < 4; y++)
+    for (int x = 2; x < 4; x++) set(x, y);
+  for (int y = 10; y < 13; y++)
+    for (int x = 10; x < 13; x++) set(x, y);
+  set(11, 11, 40.0f);
+
+  TEST_ASSERT_EQUAL(2, tracker.update(frame, THRESHOLD));
+
+  const hotspots::Blob& hottest = tracker[0];
+  TEST_ASSERT_EQUAL(9, hottest.area);
+  TEST_ASSERT_EQUAL_FLOAT(40.0f, hottest.peak);
+  TEST_ASSERT_EQUAL_FLOAT((8 * 35.0f + 40.0f) / 9, hottest.mean);
+  TEST_ASSERT_EQUAL_FLOAT(11.0f, hottest.cx);
+  TEST_ASSERT_EQUAL_FLOAT(11.0f, hottest.cy);
+  assertBox(hottest, 10, 10, 12, 12);
+
+  TEST_ASSERT_EQUAL(4, tracker[1].area);
+  TEST_ASSERT_EQUAL_FLOAT(2.5f, tracker[1].cx);
+  assertBox(tracker[1], 2, 2, 3, 3);
+
+  TEST_ASSERT_TRUE(hottest.id != 0 && tracker[1].id != 0 && hottest.id != tracker[1].id);
+}
+
+void test_u_shape_merges_on_its_last_row() {
+  // The arms get separate labels until the bottom row joins them
+  for (int y = 3; y <= 8; y++) {
+    set(5, y);
+    set(9, y);
+  }
+  for (int x = 6; x <= 8; x++) set(x, 8);
+
+  TEST_ASSERT_EQUAL(1, tracker.update(frame, THRESHOLD));
+  TEST_ASSERT_EQUAL(15, tracker[0].area);
+  assertBox(tracker[0], 5, 3, 9, 8);
+}
+
+void test_diagonals_are_connected() {
+  for (int i = 0; i < 3; i++) {
+    set(3 + i, 3 + i);   // down-right: joined through the upper-left neighbour
+    set(20 - i, 3 + i);  // down-left: joined through the upper-right one
+  }
+
+  TEST_ASSERT_EQUAL(2, tracker.update(frame, THRESHOLD));
+  for (int i = 0; i < 2; i++) TEST_ASSERT_EQUAL(3, tracker[i].area);
+  assertBox(tracker[0].x0 < 10 ? tracker[0] : tracker[1], 3, 3, 5, 5);
+  assertBox(tracker[0].x0 < 10 ? tracker[1] : tracker[0], 18, 3, 20, 5);
+}
+
+// -------------------------------------------------------------------
+// EDGES
+// -------------------------------------------------------------------
+
+void test_border_ring_is_one_region() {
+  for (int x = 0; x < W; x++) {
+    set(x, 0);
+    set(x, H - 1);
+  }
+  for (int y = 1; y < H - 1; y++) {
+    set(0, y);
+    set(W - 1, y);
+  }
+
+  TEST_ASSERT_EQUAL(1, tracker.update(frame, THRESHOLD));
+  TEST_ASSERT_EQUAL(2 * W + 2 * (H - 2), tracker[0].area);
+  assertBox(tracker[0], 0, 0, W - 1, H - 1);
+}
+
+void test_corners_stay_apart() {
+  // Distinct peaks fix the order: top-left, top-right, bottom-left, bottom-right
+  set(0, 0, 39.0f);
+  set(1, 0, 39.0f);
+  set(W - 1, 0, 38.0f);
+  set(W - 1, 1, 38.0f);
+  set(0, H - 1, 37.0f);
+  set(1, H - 2, 37.0f);
+  set(W - 1, H - 1, 36.0f);
+  set(W - 2, H - 2, 36.0f);
+
+  TEST_ASSERT_EQUAL(4, tracker.update(frame, THRESHOLD));
+  assertBox(tracker[0], 0, 0, 1, 0);
+  assertBox(tracker[1], W - 1, 0, W - 1, 1);
+  assertBox(tracker[2], 0, H - 2, 1, H - 1);
+  assertBox(tracker[3], W - 2, H - 2, W - 1, H - 1);
+}
+
+// -------------------------------------------------------------------
+// THRESHOLD AND NOISE
+// -------------------------------------------------------------------
+
+void test_threshold_is_inclusive() {
+  set(4, 4, THRESHOLD);
+  set(5, 4, THRESHOLD);
+  set(4, 10, nextafterf(THRESHOLD, 0.0f));
+  set(5, 10, nextafterf(THRESHOLD, 0.0f));
+
+  TEST_ASSERT_EQUAL(1, tracker.update(frame, THRESHOLD));
+  assertBox(tracker[0], 4, 4, 5, 4);
+}
+
+void test_nan_is_background() {
+  // Two columns bridged only by a bad pixel
+  set(10, 10);
+  set(10, 11);
+  set(11, 10, NAN);
+  set(12, 10);
+  set(12, 11);
+
+  TEST_ASSERT_EQUAL(2, tracker.update(frame, THRESHOLD));
+  for (int i = 0; i < 2; i++) TEST_ASSERT_EQUAL(2, tracker[i].area);
+}
+
+void test_small_regions_are_noise() {
+  set(3, 3);
+  set(20, 15);
+  set(8, 8);
+  set(9, 8);
+
+  TEST_ASSERT_EQUAL(1, tracker.update(frame, THRESHOLD));
+  TEST_ASSERT_EQUAL(HOTSPOTS_MIN_AREA, tracker[0].area);
+}
+
+// -------------------------------------------------------------------
+// AGAINST A FLOOD FILL
+// -------------------------------------------------------------------
+
+struct Region {
+  int area;
+  float peak;
+  int x0, y0, x1, y1;
+
+  bool operator<(const Region& o) const {
+    return std::tie(y0, x0, area, x1, y1, peak) < std::tie(o.y0, o.x0, o.area, o.x1, o.y1, o.peak);
+  }
+  bool operator==(const Region& o) const { return !(*this < o) && !(o < *this); }
+};
+
+// Straightforward 8-connected flood fill; keeps what update() would
+static std::vector<Region> floodFill() {
+  std::vector<bool> seen(W * H, false);
+  std::vector<Region> regions;
+
+  for (int start = 0; start < W * H; start++) {
+    if (seen[start] || !(frame[start] >= THRESHOLD)) continue;
+
+    Region r = {0, -INFINITY, W, H, -1, -1};
+    std::vector<int> stack(1, start);
+    seen[start] = true;
+    while (!stack.empty()) {
+      int p = stack.back();
+      stack.pop_back();
+      int x = p % W, y = p / W;
+      r.area++;
+      r.peak = std::max(r.peak, frame[p]);
+      r.x0 = std::min(r.x0, x);
+      r.y0 = std::min(r.y0, y);
+      r.x1 = std::max(r.x1, x);
+      r.y1 = std::max(r.y1, y);
+
+      for (int ny = y - 1; ny <= y + 1; ny++)
+        for (int nx = x - 1; nx <= x + 1; nx++) {
+          if (nx < 0 || ny < 0 || nx >= W || ny >= H) continue;
+          int q = ny * W + nx;
+          if (!seen[q] && frame[q] >= THRESHOLD) {
+            seen[q] = true;
+            stack.push_back(q);
+          }
+        }
+    }
+    if (r.area >= HOTSPOTS_MIN_AREA) regions.push_back(r);
+  }
+
+  std::sort(regions.begin(), regions.end(), [](const Region& a, const Region& b) { return a.peak > b.peak; });
+  if (regions.size() > HOTSPOTS_MAX_BLOBS) regions.resize(HOTSPOTS_MAX_BLOBS);
+  return regions;
+}
+
+void test_matches_flood_fill_on_random_frames() {
+  uint32_t seed = 1;
+  for (int round = 0; round < 2000; round++) {
+    // From empty to nearly solid; distinct peaks keep the hottest-first
+    // cut unambiguous
+    float density = (round % 10) / 10.0f;
+    for (int i = 0; i < W * H; i++) {
+      seed = seed * 1664525u + 1013904223u;
+      frame[i] = (seed >> 8) % 1000 < density * 1000 ? THRESHOLD + i / 100.0f : COLD;
+    }
+
+    std::vector<Region> expected = floodFill();
+    uint8_t n = tracker.update(frame, THRESHOLD);
+    TEST_ASSERT_EQUAL(expected.size(), n);
+
+    std::vector<Region> found;
+    for (uint8_t i = 0; i < n; i++) {
+      const hotspots::Blob& b = tracker[i];
+      if (i > 0) TEST_ASSERT_TRUE(tracker[i - 1].peak >= b.peak);
+      found.push_back({b.area, b.peak, b.x0, b.y0, b.x1, b.y1});
+    }
+    std::sort(expected.begin(), expected.end());
+    std::sort(found.begin(), found.end());
+    TEST_ASSERT_TRUE(expected == found);
+  }
+}
+
+// -------------------------------------------------------------------
+// TRACKING
+// -------------------------------------------------------------------
+
+void test_moving_blob_keeps_its_id() {
+  square(2, 10);
+  TEST_ASSERT_EQUAL(1, tracker.update(frame, THRESHOLD));
+  uint8_t id = tracker[0].id;
+  TEST_ASSERT_TRUE(id != 0);
+
+  // Two pixels a frame, well inside HOTSPOTS_MATCH_DISTANCE
+  for (int step = 1; step <= 12; step++) {
+    clear();
+    square(2 + 2 * step, 10 + (step & 1));
+    TEST_ASSERT_EQUAL(1, tracker.update(frame, THRESHOLD));
+    TEST_ASSERT_EQUAL(id, tracker[0].id);
+    TEST_ASSERT_EQUAL(step + 1, tracker[0].age);
+  }
+}
+
+void test_track_goes_to_nearest_blob() {
+  square(4, 10);
+  square(10, 10, 40.0f);
+  TEST_ASSERT_EQUAL(2, tracker.update(frame, THRESHOLD));
+  uint8_t left = tracker[1].id, right = tracker[0].id;
+
+  // Both move and swap which is hotter: ids follow position, not order
+  clear();
+  square(5, 11, 40.0f);
+  square(11, 9);
+  TEST_ASSERT_EQUAL(2, tracker.update(frame, THRESHOLD));
+  TEST_ASSERT_EQUAL(left, tracker[0].id);
+  TEST_ASSERT_EQUAL(right, tracker[1].id);
+
+  // One blob within reach of both tracks: 3 px from the left one, 1 px
+  // from the right one
+  clear();
+  square(10, 10);
+  TEST_ASSERT_EQUAL(1, tracker.update(frame, THRESHOLD));
+  TEST_ASSERT_EQUAL(right, tracker[0].id);
+}
+
+void test_missed_track_survives_then_expires() {
+  square(10, 10);
+  tracker.update(frame, THRESHOLD);
+  uint8_t id = tracker[0].id;
+
+  // Gone for HOTSPOTS_MAX_MISSED frames: back under the same id
+  clear();
+  for (int i = 0; i < HOTSPOTS_MAX_MISSED; i++) TEST_ASSERT_EQUAL(0, tracker.update(frame, THRESHOLD));
+  square(10, 10);
+  TEST_ASSERT_EQUAL(1, tracker.update(frame, THRESHOLD));
+  TEST_ASSERT_EQUAL(id, tracker[0].id);
+
+  // One frame longer and the track is dropped: a new id
+  clear();
+  for (int i = 0; i < HOTSPOTS_MAX_MISSED + 1; i++) tracker.update(frame, THRESHOLD);
+  square(10, 10);
+  TEST_ASSERT_EQUAL(1, tracker.update(frame, THRESHOLD));
+  TEST_ASSERT_TRUE(tracker[0].id != 0 && tracker[0].id != id);
+  TEST_ASSERT_EQUAL(1, tracker[0].age);
+}
+
+void test_new_ids_wrap_around_live_ones() {
+  // A blob that stays put holds id 1 throughout
+  square(2, 2);
+  tracker.update(frame, THRESHOLD);
+  TEST_ASSERT_EQUAL(1, tracker[0].id);
+
+  // A far one that keeps expiring takes 2..255, then wraps past 0 and the
+  // live 1 to 2
+  for (int expected = 2; expected <= 256; expected++) {
+    clear();
+    square(2, 2);
+    square(25, 18);
+    TEST_ASSERT_EQUAL(2, tracker.update(frame, THRESHOLD));
+    const hotspots::Blob& far = tracker[0].x0 == 25 ? tracker[0] : tracker[1];
+    const hotspots::Blob& held = tracker[0].x0 == 25 ? tracker[1] : tracker[0];
+    TEST_ASSERT_EQUAL(1, held.id);
+    TEST_ASSERT_EQUAL(expected <= 255 ? expected : 2, far.id);
+
+    clear();
+    square(2, 2);
+    for (int i = 0; i < HOTSPOTS_MAX_MISSED + 1; i++) tracker.update(frame, THRESHOLD);
+  }
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_separate_regions);
+  RUN_TEST(test_u_shape_merges_on_its_last_row);
+  RUN_TEST(test_diagonals_are_connected);
+  RUN_TEST(test_border_ring_is_one_region);
+  RUN_TEST(test_corners_stay_apart);
+  RUN_TEST(test_threshold_is_inclusive);
+  RUN_TEST(test_nan_is_background);
+  RUN_TEST(test_small_regions_are_noise);
+  RUN_TEST(test_matches_flood_fill_on_random_frames);
+  RUN_TEST(test_moving_blob_keeps_its_id);
+  RUN_TEST(test_track_goes_to_nearest_blob);
+  RUN_TEST(test_missed_track_survives_then_expires);
+  RUN_TEST(test_new_ids_wrap_around_live_ones);
+  return UNITY_END();
+}
@@ -0,0 +1,196 @@
+// Logger ring and formatting, on the host:
+//
+//   pio test -e native -f test_logger
+
+#include <Logger.h>
+#include <string>
+#include <unity.h>
+
+#define TEN_CHARS "0123456789"
+
+// Collects everything drain() prints
+class Capture : public Print {
+public:
+  size_t write(uint8_t c) override {
+    text += (char)c;
+    return 1;
+  }
+  size_t write(const uint8_t* data, size_t len) override {
+    text.append((const char*)data, len);
+    return len;
+  }
+
+  std::string text;
+};
+
+// Drains the ring and returns one line per message with the timestamp cut
+// off ("I text\n"); drop reports are kept whole
+static std::string drained() {
+  Capture out;
+  logger::drain(out);
+
+  std::string lines;
+  size_t pos = 0, end;
+  while ((end = out.text.find("\r\n", pos)) != std::string::npos) {
+    std::string line = out.text.substr(pos, end - pos);
+    if (line.compare(0, 5, "[log]") != 0) line = line.substr(line.find("] ") + 2);
+    lines += line + "\n";
+    pos = end + 2;
+  }
+  return lines;
+}
+
+void setUp() {
+  drained(); // start every test with an empty ring
+}
+
+void tearDown() {}
+
+// -------------------------------------------------------------------
+// FORMATTING
+// -------------------------------------------------------------------
+
+void test_formats_each_argument_type() {
+  LOG_INFO("int %d uint %u neg %ld ll %lld f %.2f s %s", -5, 7u, -9L, 1LL << 40, 3.14159, "str");
+  LOG_WARN("pad [%5d] [%-4s] [%05.1f] %%", 42, "ab", 2.5);
+  TEST_ASSERT_EQUAL_STRING("I int -5 uint 7 neg -9 ll 1099511627776 f 3.14 s str\n"
+                           "W pad [   42] [ab  ] [002.5] %\n",
+                           drained().c_str());
+}
+
+void test_missing_arguments_print_placeholder() {
+  LOG_INFO("%d %d %d %d %d %d %d", 1, 2, 3, 4, 5, 6, 7); // one more than LOGGER_MAX_ARGS
+  TEST_ASSERT_EQUAL_STRING("I 1 2 3 4 5 6 <?>\n", drained().c_str());
+}
+
+void test_arguments_that_do_not_fit_keep_their_place() {
+  // Six doubles need 48 bytes: whatever doesn't fit prints as <?>, and
+  // nothing after it moves up a slot
+  const int fit = LOGGER_PAYLOAD / 8 < 6 ? LOGGER_PAYLOAD / 8 : 6;
+  LOG_INFO("%.0f %.0f %.0f %.0f %.0f %.0f", 1.0, 2.0, 3.0, 4.0, 5.0, 6.0);
+
+  std::string expected = "I";
+  for (int i = 1; i <= 6; i++) expected += i <= fit ? " " + std::to_string(i) : std::string(" <?>");
+  TEST_ASSERT_EQUAL_STRING((expected + "\n").c_str(), drained().c_str());
+
+#if LOGGER_PAYLOAD == 40
+  // The string would leave no room for the double after it, so it is the
+  // one skipped and the double still lands in the last slot
+  LOG_INFO("%.0f %.0f %.0f %.0f %s %.0f", 1.0, 2.0, 3.0, 4.0, "text", 6.0);
+  TEST_ASSERT_EQUAL_STRING("I 1 2 3 4 <?> 6\n", drained().c_str());
+#endif
+}
+
+// -------------------------------------------------------------------
+// TRUNCATION
+// -------------------------------------------------------------------
+
+void test_truncates_strings_to_the_slot() {
+  std::string longText(3 * LOGGER_PAYLOAD, 'a');
+  LOG_INFO("%s", longText.c_str());
+  LOG_INFO("%d %s", 1, longText.c_str()); // the int leaves 4 bytes less
+
+  std::string expected = "I " + std::string(LOGGER_PAYLOAD - 1, 'a') + "\n" +
+                         "I 1 " + std::string(LOGGER_PAYLOAD - 1 - 4, 'a') + "\n";
+  TEST_ASSERT_EQUAL_STRING(expected.c_str(), drained().c_str());
+}
+
+void test_strings_leave_room_for_later_arguments() {
+  std::string longText(3 * LOGGER_PAYLOAD, 'a');
+  LOG_INFO("%s %d %.1f", longText.c_str(), 7, 2.5);
+
+  // Two strings split what the int leaves between them
+  LOG_INFO("%s|%s|%d", longText.c_str(), "bb", 9);
+
+  size_t first = LOGGER_PAYLOAD - 1 - 4 - 8;
+  size_t share = (LOGGER_PAYLOAD - 1 - (1 + 4)) / 2;
+  std::string expected = "I " + std::string(first, 'a') + " 7 2.5\n" +
+                         "I " + std::string(share, 'a') + "|bb|9\n";
+  TEST_ASSERT_EQUAL_STRING(expected.c_str(), drained().c_str());
+}
+
+void test_truncates_long_lines() {
+  // 200 characters of format alone
+  LOG_INFO(TEN_CHARS TEN_CHARS TEN_CHARS TEN_CHARS TEN_CHARS TEN_CHARS TEN_CHARS TEN_CHARS TEN_CHARS TEN_CHARS
+           TEN_CHARS TEN_CHARS TEN_CHARS TEN_CHARS TEN_CHARS TEN_CHARS TEN_CHARS TEN_CHARS TEN_CHARS TEN_CHARS);
+
+  Capture out;
+  TEST_ASSERT_EQUAL(1, logger::drain(out));
+  TEST_ASSERT_EQUAL(LOGGER_LINE_MAX - 1 + 2, out.text.size()); // + "\r\n"
+  TEST_ASSERT_EQUAL_STRING("\r\n", out.text.c_str() + out.text.size() - 2);
+}
+
+// -------------------------------------------------------------------
+// RING
+// -------------------------------------------------------------------
+
+void test_wraps_around() {
+  uint32_t drops = logger::dropped();
+
+  // Three quarters of the ring per round: the slots in use move all the
+  // way around it several times
+  int next = 0;
+  for (int round = 0; round < 6; round++) {
+    std::string expected;
+    for (int i = 0; i < LOGGER_SLOTS * 3 / 4; i++, next++) {
+      LOG_INFO("message %d", next);
+      expected += "I message " + std::to_string(next) + "\n";
+    }
+    TEST_ASSERT_EQUAL_STRING(expected.c_str(), drained().c_str());
+  }
+  TEST_ASSERT_EQUAL(drops, logger::dropped());
+}
+
+void test_drops_when_full() {
+  uint32_t drops = logger::dropped();
+
+  std::string expected;
+  for (int i = 0; i < LOGGER_SLOTS; i++) {
+    LOG_INFO("kept %d", i);
+    expected += "I kept " + std::to_string(i) + "\n";
+  }
+  TEST_ASSERT_EQUAL(drops, logger::dropped());
+
+  // Full: these are counted and lost, the queued ones are untouched and
+  // the report comes after them, where the lost ones would have been
+  LOG_INFO("lost %d", 1);
+  logger::Record r = {};
+  TEST_ASSERT_FALSE(logger::push(r));
+  TEST_ASSERT_EQUAL(drops + 2, logger::dropped());
+  expected += "[log] 2 messages dropped\n";
+  TEST_ASSERT_EQUAL_STRING(expected.c_str(), drained().c_str());
+
+  // Draining made room again, and the drops are only reported once
+  LOG_INFO("after %d", 1);
+  TEST_ASSERT_EQUAL_STRING("I after 1\n", drained().c_str());
+}
+
+void test_drop_report_travels_with_the_next_message() {
+  for (int i = 0; i < LOGGER_SLOTS; i++) LOG_INFO("kept %d", i);
+  LOG_INFO("lost %d", 1);
+
+  // Room for one: the report is printed just before it, after the
+  // messages that were queued ahead of the drop
+  Capture out;
+  TEST_ASSERT_EQUAL(1, logger::drain(out, 1));
+  LOG_INFO("next %d", 1);
+
+  std::string expected;
+  for (int i = 1; i < LOGGER_SLOTS; i++) expected += "I kept " + std::to_string(i) + "\n";
+  expected += "[log] 1 messages dropped\nI next 1\n";
+  TEST_ASSERT_EQUAL_STRING(expected.c_str(), drained().c_str());
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_formats_each_argument_type);
+  RUN_TEST(test_missing_arguments_print_placeholder);
+  RUN_TEST(test_arguments_that_do_not_fit_keep_their_place);
+  RUN_TEST(test_truncates_strings_to_the_slot);
+  RUN_TEST(test_strings_leave_room_for_later_arguments);
+  RUN_TEST(test_truncates_long_lines);
+  RUN_TEST(test_wraps_around);
+  RUN_TEST(test_drops_when_full);
+  RUN_TEST(test_drop_report_travels_with_the_next_message);
+  return UNITY_END();
+}
@@ -1,34 +1,112 @@
 #include <Arduino.h>
 #include <Wire.h>
 
+// I2C bus diagnostics:
+//   1. Scan addresses 1-126 and identify known parts from their ID registers
+//   2. Benchmark sustained reads on each known device at 100 kHz, 400 kHz
+//      and 1 MHz, checking every byte of every read against a reference
+//   3. Recommend the highest clock that was error-free on every device
+// The scan repeats every 5 seconds; diagnostics rerun when the bus changes.
+
 // Your defined pins
 #define I2C_SDA 16
 #define I2C_SCL 17
 
+// --- CONFIGURATION ---
+#define SCAN_INTERVAL_MS   5000
+#define BENCH_READS        200      // reads per device per clock
+#define REFERENCE_CLOCK    100000   // reference block is captured at the safest speed
+
+const uint32_t BENCH_CLOCKS[] = { 100000, 400000, 1000000 };
+#define NUM_CLOCKS (sizeof(BENCH_CLOCKS) / sizeof(BENCH_CLOCKS[0]))
+
+// Largest block any benchmark reads (Wire buffer is 128 bytes on ESP32)
+#define MAX_BLOCK 66
+
+// --- KNOWN DEVICES ---
+enum DeviceType { DEV_UNKNOWN, DEV_MLX90640, DEV_AHT20, DEV_BMP280, DEV_BME280 };
+
+struct Device {
+  uint8_t address;
+  DeviceType type;
+  char detail[48];
+  // Benchmark results, one per entry in BENCH_CLOCKS
+  uint32_t bytesPerSec[NUM_CLOCKS];
+  uint16_t errors[NUM_CLOCKS];
+};
+
+#define MAX_DEVICES 16
+Device devices[MAX_DEVICES];
+uint8_t numDevices = 0;
+
+// Bitmap of responding addresses from the last scan
+uint32_t lastScan[4] = { 0, 0, 0, 0 };
+
+// Function Prototypes
+bool scanBus(uint32_t found[4]);
+void runDiagnostics(const uint32_t found[4]);
+DeviceType identify(uint8_t address, char* detail, size_t len);
+bool readBlock(const Device& dev, uint8_t* buf, size_t& len);
+bool dataChanged(const Device& dev, uint8_t* reference, const uint8_t* buf, uint32_t clock);
+void benchmark(Device& dev);
+void printReport();
+const char* typeName(DeviceType type);
+
+// -------------------------------------------------------------------
+// SETUP
+// -------------------------------------------------------------------
 void setup() {
   Serial.begin(115200);
   while (!Serial); // Wait for serial monitor
-  Serial.println("\nI2C Scanner");
+  Serial.println("\nI2C Bus Diagnostics");
 
   // Force the ESP32-S3 to use these specific pins
   Wire.begin(I2C_SDA, I2C_SCL);
+  Wire.setClock(REFERENCE_CLOCK);
 }
 
+// -------------------------------------------------------------------
+// LOOP
+// -------------------------------------------------------------------
 void loop() {
+  uint32_t found[4];
+
+  Serial.println("Scanning...");
+  bool any = scanBus(found);
+
+  if (!any) {
+    Serial.println("No I2C devices found\n");
+    Serial.println("Check: 1. Wiring (SDA/SCL swapped?)");
+    Serial.println("       2. Voltage (Try 3.3V instead of 5V)");
+    Serial.println("       3. Pull-up resistors needed?");
+  } else if (memcmp(found, lastScan, sizeof(lastScan)) != 0) {
+    // New or removed devices: fingerprint and benchmark again
+    runDiagnostics(found);
+  } else {
+    Serial.println("Bus unchanged.\n");
+  }
+  memcpy(lastScan, found, sizeof(lastScan));
+
+  delay(SCAN_INTERVAL_MS);
+}
+
+// -------------------------------------------------------------------
+// SCAN
+// -------------------------------------------------------------------
+
+bool scanBus(uint32_t found[4]) {
   byte error, address;
   int nDevices = 0;
 
-  Serial.println("Scanning...");
+  memset(found, 0, 4 * sizeof(uint32_t));
+  Wire.setClock(REFERENCE_CLOCK);
 
   for (address = 1; address < 127; address++) {
     Wire.beginTransmission(address);
     error = Wire.endTransmission();
 
     if (error == 0) {
-      Serial.print("I2C device found at address 0x");
-      if (address < 16) Serial.print("0");
-      Serial.print(address, HEX);
-      Serial.println("  !");
+      found[address / 32] |= 1UL << (address % 32);
       nDevices++;
     } else if (error == 4) {
       Serial.print("Unknown error at address 0x");
@@ -36,15 +114,230 @@ void loop() {
       Serial.println(address, HEX);
     }
   }
-  
-  if (nDevices == 0) {
-    Serial.println("No I2C devices found\n");
-    Serial.println("Check: 1. Wiring (SDA/SCL swapped?)");
-    Serial.println("       2. Voltage (Try 3.3V instead of 5V)");
-    Serial.println("       3. Pull-up resistors needed?");
+
+  return nDevices > 0;
+}
+
+void runDiagnostics(const uint32_t found[4]) {
+  numDevices = 0;
+
+  for (uint8_t address = 1; address < 127 && numDevices < MAX_DEVICES; address++) {
+    if (!(found[address / 32] & (1UL << (address % 32)))) continue;
+
+    Device& dev = devices[numDevices++];
+    memset(&dev, 0, sizeof(dev));
+    dev.address = address;
+    dev.type = identify(address, dev.detail, sizeof(dev.detail));
+
+    Serial.printf("I2C device found at address 0x%02X  %s %s\n",
+                  address, typeName(dev.type), dev.detail);
+  }
+
+  for (uint8_t i = 0; i < numDevices; i++) {
+    if (devices[i].type != DEV_UNKNOWN) benchmark(devices[i]);
+  }
+
+  // Leave the bus at the safe speed for the next scan
+  Wire.setClock(REFERENCE_CLOCK);
+  printReport();
+}
+
+// -------------------------------------------------------------------
+// REGISTER ACCESS
+// -------------------------------------------------------------------
+
+// Write a register address (1 or 2 bytes, MSB first) then read len bytes.
+// Returns false on NACK, bus error or short read.
+bool readRegs(uint8_t address, uint16_t reg, uint8_t regBytes, uint8_t* buf, size_t len) {
+  Wire.beginTransmission(address);
+  if (regBytes == 2) Wire.write((uint8_t)(reg >> 8));
+  Wire.write((uint8_t)reg);
+  if (Wire.endTransmission(false) != 0) return false;
+
+  if (Wire.requestFrom(address, (uint8_t)len) != len) return false;
+  for (size_t i = 0; i < len; i++) buf[i] = Wire.read();
+  return true;
+}
+
+// Plain read without a register pointer (AHT20 returns status + data)
+bool readRaw(uint8_t address, uint8_t* buf, size_t len) {
+  if (Wire.requestFrom(address, (uint8_t)len) != len) return false;
+  for (size_t i = 0; i < len; i++) buf[i] = Wire.read();
+  return true;
+}
+
+// -------------------------------------------------------------------
+// FINGERPRINTING
+// -------------------------------------------------------------------
+
+DeviceType identify(uint8_t address, char* detail, size_t len) {
+  uint8_t buf[8];
+
+  // MLX90640: 48-bit device ID in EEPROM words 0x2407-0x2409,
+  // refresh rate in bits 7-9 of control register 0x800D
+  if (address == 0x33 && readRegs(address, 0x2407, 2, buf, 6)) {
+    uint16_t id1 = (buf[0] << 8) | buf[1];
+    uint16_t id2 = (buf[2] << 8) | buf[3];
+    uint16_t id3 = (buf[4] << 8) | buf[5];
+    bool blank = (id1 == 0 && id2 == 0 && id3 == 0) || (id1 == 0xFFFF && id2 == 0xFFFF && id3 == 0xFFFF);
+
+    if (!blank && readRegs(address, 0x800D, 2, buf, 2)) {
+      uint16_t ctrl = (buf[0] << 8) | buf[1];
+      uint8_t rate = (ctrl >> 7) & 0x07;
+      snprintf(detail, len, "(ID %04X-%04X-%04X, refresh code %u)", id1, id2, id3, rate);
+      return DEV_MLX90640;
+    }
+  }
+
+  // AHT20: no ID register; status command 0x71 answers with bit 3 = calibrated
+  if (address == 0x38) {
+    Wire.beginTransmission(address);
+    Wire.write(0x71);
+    if (Wire.endTransmission() == 0 && readRaw(address, buf, 1)) {
+      snprintf(detail, len, "(status 0x%02X, %s)", buf[0], (buf[0] & 0x08) ? "calibrated" : "NOT calibrated");
+      return DEV_AHT20;
+    }
+  }
+
+  // BMP280 / BME280: chip ID register 0xD0
+  if ((address == 0x76 || address == 0x77) && readRegs(address, 0xD0, 1, buf, 1)) {
+    snprintf(detail, len, "(chip ID 0x%02X)", buf[0]);
+    if (buf[0] == 0x58) return DEV_BMP280;
+    if (buf[0] == 0x60) return DEV_BME280;
+  }
+
+  detail[0] = '\0';
+  return DEV_UNKNOWN;
+}
+
+const char* typeName(DeviceType type) {
+  switch (type) {
+    case DEV_MLX90640: return "MLX90640";
+    case DEV_AHT20:    return "AHT20";
+    case DEV_BMP280:   return "BMP280";
+    case DEV_BME280:   return "BME280";
+    default:           return "unknown";
+  }
+}
+
+// -------------------------------------------------------------------
+// BENCHMARK
+// -------------------------------------------------------------------
+
+// Reads the block of `len` bytes each device is benchmarked with:
+//   MLX90640  control register 1 (0x800D) then 64 bytes of frame RAM from
+//             0x0400: the register-then-RAM pattern the camera reads every
+//             subpage. EEPROM is not used, it is only specified up to
+//             400 kHz. The RAM holds live pixels (see dataChanged()).
+//   BMP/BME   24 bytes of trimming parameters from 0x88
+//   AHT20     status + last measurement (7 bytes; no new measurement is triggered)
+bool readBlock(const Device& dev, uint8_t* buf, size_t& len) {
+  switch (dev.type) {
+    case DEV_MLX90640:
+      len = 66;
+      return readRegs(dev.address, 0x800D, 2, buf, 2) &&
+             readRegs(dev.address, 0x0400, 2, buf + 2, len - 2);
+    case DEV_BMP280:
+    case DEV_BME280:
+      len = 24;
+      return readRegs(dev.address, 0x88, 1, buf, len);
+    case DEV_AHT20:
+      len = 7;
+      return readRaw(dev.address, buf, len);
+    default:
+      len = 0;
+      return false;
+  }
+}
+
+// Called when a read at `clock` differs from the reference. Reads again at
+// REFERENCE_CLOCK, which becomes the new reference: if it agrees with the
+// fast read, the device's data moved on (a new MLX90640 subpage) and the
+// read was good; otherwise the fast read was corrupted.
+bool dataChanged(const Device& dev, uint8_t* reference, const uint8_t* buf, uint32_t clock) {
+  size_t len = 0;
+  Wire.setClock(REFERENCE_CLOCK);
+  bool ok = readBlock(dev, reference, len);
+  Wire.setClock(clock);
+  return ok && memcmp(reference, buf, len) == 0;
+}
+
+void benchmark(Device& dev) {
+  uint8_t reference[MAX_BLOCK];
+  uint8_t buf[MAX_BLOCK];
+  size_t len = 0;
+
+  Wire.setClock(REFERENCE_CLOCK);
+  if (!readBlock(dev, reference, len)) {
+    // Can't establish a reference: count every clock as failed
+    for (uint8_t c = 0; c < NUM_CLOCKS; c++) dev.errors[c] = BENCH_READS;
+    return;
+  }
+
+  for (uint8_t c = 0; c < NUM_CLOCKS; c++) {
+    Wire.setClock(BENCH_CLOCKS[c]);
+    uint16_t errors = 0;
+
+    // Only the reads at this clock are timed, not the confirming ones
+    uint32_t elapsed = 0;
+    for (int i = 0; i < BENCH_READS; i++) {
+      size_t got = 0;
+      uint32_t start = micros();
+      bool ok = readBlock(dev, buf, got);
+      elapsed += micros() - start;
+
+      if (ok && memcmp(buf, reference, len) == 0) continue;
+      if (ok && dataChanged(dev, reference, buf, BENCH_CLOCKS[c])) continue;
+      errors++;
+    }
+
+    dev.errors[c] = errors;
+    dev.bytesPerSec[c] = elapsed ? (uint64_t)len * BENCH_READS * 1000000ULL / elapsed : 0;
+
+    // A clock that fails outright tends to fail harder above it; and a
+    // wedged bus is better recovered at the reference speed
+    if (errors == BENCH_READS) {
+      for (uint8_t rest = c + 1; rest < NUM_CLOCKS; rest++) dev.errors[rest] = BENCH_READS;
+      break;
+    }
+  }
+  Wire.setClock(REFERENCE_CLOCK);
+}
+
+void printReport() {
+  Serial.println("\nThroughput (payload bytes/s) and read errors per clock:");
+  Serial.print("  Device         Addr ");
+  for (uint8_t c = 0; c < NUM_CLOCKS; c++) Serial.printf(" %12lu Hz", (unsigned long)BENCH_CLOCKS[c]);
+  Serial.println();
+
+  // Highest clock at which every benchmarked device (and every slower clock) was clean
+  int8_t bestBus = NUM_CLOCKS - 1;
+  bool anyBenchmarked = false;
+
+  for (uint8_t i = 0; i < numDevices; i++) {
+    const Device& dev = devices[i];
+    if (dev.type == DEV_UNKNOWN) continue;
+    anyBenchmarked = true;
+
+    Serial.printf("  %-14s 0x%02X ", typeName(dev.type), dev.address);
+    int8_t bestDev = -1;
+    for (uint8_t c = 0; c < NUM_CLOCKS; c++) {
+      Serial.printf(" %7lu/%3u err", (unsigned long)dev.bytesPerSec[c], dev.errors[c]);
+      if (dev.errors[c] == 0 && bestDev == c - 1) bestDev = c;
+    }
+    Serial.println();
+
+    if (bestDev < bestBus) bestBus = bestDev;
+  }
+
+  if (!anyBenchmarked) {
+    Serial.println("  (no known devices to benchmark)\n");
+    return;
+  }
+
+  if (bestBus < 0) {
+    Serial.println("\nErrors even at 100 kHz: check wiring and pull-ups before going faster.\n");
   } else {
-    Serial.println("done\n");
+    Serial.printf("\nHighest reliable clock: Wire.setClock(%lu);\n\n", (unsigned long)BENCH_CLOCKS[bestBus]);
   }
-  
-  delay(5000); 
-}
\ No newline at end of file
+}
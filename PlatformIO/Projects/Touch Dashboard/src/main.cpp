@@ -0,0 +1,438 @@
+#include "secrets.h"
+#include <Arduino.h>
+#include <WiFi.h>
+#include <HTTPClient.h>
+#include <NTPClient.h>
+#include <ArduinoJson.h>
+#include <Wire.h>
+#include <Adafruit_GFX.h>
+#include <Adafruit_MLX90640.h>
+#include <TFTDisplay.h>
+#include <TFTTouch.h>
+#include <TouchUI.h>
+#include <UIDisplayTarget.h>
+#include <Logger.h>
+
+#include <Fonts/FreeSansBold18pt7b.h>
+#include <Fonts/FreeSans12pt7b.h>
+#include <Fonts/FreeSans9pt7b.h>
+
+// Clock, weather and IR camera on one touch-driven device.
+// Each page is a retained ui::Screen; switching pages or updating a value
+// only repaints what changed.
+
+// --- PIN DEFINITIONS ---
+// Display Pins: see TFTPins.h
+
+// Touch Pins
+#define T_CS      5
+#define T_MISO    9
+#define T_IRQ     7
+
+// IR Sensor Pins (I2C)
+#define I2C_SDA   16
+#define I2C_SCL   17
+
+// --- CONFIGURATION ---
+#define MLX90640_I2C_ADDR 0x33
+
+// Touch calibration (Landscape Mode: Rotation 1)
+#define TS_MINX 120
+#define TS_MAXX 920
+#define TS_MINY 100
+#define TS_MAXY 900
+#define MIN_PRESSURE 1
+
+// Fetch weather every 15 minutes
+#define WEATHER_INTERVAL_MS 900000
+
+const char* WEATHER_UNIT = "metric"; // metric, imperial or standard
+const char* WEATHER_LANGUAGE = "en";
+
+// Labels for the units OpenWeatherMap reports in WEATHER_UNIT (metric wind
+// is converted from m/s to km/h before display)
+const char* tempUnit() {
+  if (strcmp(WEATHER_UNIT, "metric") == 0) return " C";
+  if (strcmp(WEATHER_UNIT, "imperial") == 0) return " F";
+  return " K";
+}
+
+const char* windUnit() {
+  if (strcmp(WEATHER_UNIT, "metric") == 0) return " km/h";
+  if (strcmp(WEATHER_UNIT, "imperial") == 0) return " mph";
+  return " m/s";
+}
+
+TFTDisplay tft(TFT_CS, TFT_DC, TFT_RST, TFT_MOSI, TFT_SCK, T_MISO);
+TFTTouch ts(tft, T_CS, T_IRQ);
+Adafruit_MLX90640 mlx;
+
+WiFiUDP ntpUDP;
+NTPClient timeClient(ntpUDP, "pool.ntp.org", TIMEZONE_OFFSET_HRS * 3600);
+
+float frame[32 * 24];
+bool sensorReady = false;
+bool ntpStarted = false;
+
+// Function Prototypes
+enum Page { PAGE_CLOCK, PAGE_WEATHER, PAGE_IR };
+void showPage(Page page);
+void initializeDisplay();
+void connectWiFi();
+void initializeSensor();
+void readTouch();
+void updateClock();
+void updateWeather();
+void updateThermal();
+bool fetchWeather();
+
+// -------------------------------------------------------------------
+// CUSTOM WIDGETS
+// -------------------------------------------------------------------
+
+// OpenWeatherMap icon code drawn with primitives (same shapes as Weather
+// Station); the compositor clips whatever overhangs the bounds
+class WeatherIcon : public ui::Widget {
+public:
+  explicit WeatherIcon(const ui::Rect& bounds) : ui::Widget(bounds) { code[0] = '\0'; }
+
+  void setCode(const String& iconCode) {
+    if (iconCode.equals(code)) return;
+    strncpy(code, iconCode.c_str(), sizeof(code) - 1);
+    code[sizeof(code) - 1] = '\0';
+    invalidate();
+  }
+
+  void draw(Adafruit_GFX& g, const ui::Rect& clip) override {
+    int16_t x = _bounds.x + _bounds.w / 2;
+    int16_t y = _bounds.y + _bounds.h / 2;
+    String icon(code);
+
+    if (icon.length() == 0) return;
+    if (icon.startsWith("01")) {
+      g.fillCircle(x, y, 20, ILI9341_YELLOW);
+    } else if (icon.startsWith("09") || icon.startsWith("10")) {
+      g.fillCircle(x, y, 15, ILI9341_LIGHTGREY);
+      g.drawLine(x - 10, y + 20, x - 5, y + 25, ILI9341_BLUE);
+      g.drawLine(x, y + 20, x + 5, y + 25, ILI9341_BLUE);
+    } else if (icon.startsWith("0")) {
+      g.fillCircle(x, y, 15, ILI9341_LIGHTGREY);
+      g.fillCircle(x + 10, y + 5, 15, ILI9341_LIGHTGREY);
+    } else if (icon.startsWith("13")) {
+      g.fillCircle(x, y, 15, ILI9341_WHITE);
+      g.drawCircle(x, y, 10, ILI9341_WHITE);
+    } else {
+      g.drawRect(x - 10, y - 10, 20, 20, ILI9341_RED);
+    }
+  }
+
+private:
+  char code[8];
+};
+
+// Crosshair marking the pixel reported as the center temperature
+class Crosshair : public ui::Widget {
+public:
+  explicit Crosshair(const ui::Rect& bounds) : ui::Widget(bounds) {}
+
+  void draw(Adafruit_GFX& g, const ui::Rect& clip) override {
+    int16_t cx = _bounds.x + _bounds.w / 2;
+    int16_t cy = _bounds.y + _bounds.h / 2;
+    g.drawFastHLine(_bounds.x, cy, _bounds.w, ILI9341_WHITE);
+    g.drawFastVLine(cx, _bounds.y, _bounds.h, ILI9341_WHITE);
+  }
+};
+
+// Page switcher shown along the bottom of every page
+struct TabBar {
+  ui::Button clock   { ui::Rect(4, 206, 100, 30),   "CLOCK",   [](ui::Button&) { showPage(PAGE_CLOCK); } };
+  ui::Button weather { ui::Rect(110, 206, 100, 30), "WEATHER", [](ui::Button&) { showPage(PAGE_WEATHER); } };
+  ui::Button ir      { ui::Rect(216, 206, 100, 30), "IR",      [](ui::Button&) { showPage(PAGE_IR); } };
+
+  void addTo(ui::Screen& screen, ui::Button& active) {
+    active.setColors(ILI9341_DARKCYAN, ILI9341_DARKGREY, ILI9341_WHITE);
+    screen.add(clock);
+    screen.add(weather);
+    screen.add(ir);
+  }
+};
+
+// -------------------------------------------------------------------
+// SCREENS
+// -------------------------------------------------------------------
+ui::DisplayTarget uiTarget(tft);
+ui::Compositor compositor(uiTarget);
+Page activePage = PAGE_CLOCK;
+
+// Clock
+ui::Screen clockScreen(ILI9341_BLACK);
+ui::Label clockTime(ui::Rect(0, 70, 320, 40), "--:--:--", ILI9341_WHITE);
+ui::Label clockStatus(ui::Rect(0, 150, 320, 16), "Connecting to WiFi...", ILI9341_YELLOW);
+TabBar clockTabs;
+
+// Weather
+ui::Screen weatherScreen(ILI9341_BLACK);
+ui::Label weatherTemp(ui::Rect(5, 5, 250, 40), "--", ILI9341_CYAN);
+ui::Label weatherHiLo(ui::Rect(5, 48, 250, 24), "", ILI9341_ORANGE);
+ui::Label weatherDesc(ui::Rect(5, 76, 310, 24), "Fetching weather...", ILI9341_WHITE);
+ui::ValueField weatherHumidity(ui::Rect(5, 120, 310, 20), "Humidity: ", "%", 0, ILI9341_LIGHTGREY);
+ui::ValueField weatherFeels(ui::Rect(5, 145, 310, 20), "Feels Like: ", tempUnit(), 1, ILI9341_LIGHTGREY);
+ui::ValueField weatherWind(ui::Rect(5, 170, 310, 20), "Wind: ", windUnit(), 1, ILI9341_LIGHTGREY);
+WeatherIcon weatherIcon(ui::Rect(255, 10, 60, 60));
+TabBar weatherTabs;
+
+// IR camera: 32x24 sensor scaled x8 -> 256x192, readouts on the right
+ui::Screen irScreen(ILI9341_BLACK);
+ui::ThermalView irView(ui::Rect(0, 0, 256, 192));
+Crosshair irCross(ui::Rect(128 - 10, 96 - 10, 21, 21));
+ui::ValueField irCenter(ui::Rect(260, 10, 60, 16), "", "C", 1, ILI9341_WHITE);
+ui::ValueField irMax(ui::Rect(260, 40, 60, 12), "Max ", "", 0, ILI9341_RED);
+ui::ValueField irMin(ui::Rect(260, 58, 60, 12), "Min ", "", 0, ILI9341_CYAN);
+ui::Graph irTrend(ui::Rect(260, 80, 58, 112), 15.0, 45.0, ILI9341_YELLOW);
+TabBar irTabs;
+
+void buildScreens() {
+  clockTime.setTextSize(5);
+  clockTime.setAlign(ui::Label::CENTER);
+  clockStatus.setTextSize(2);
+  clockStatus.setAlign(ui::Label::CENTER);
+  clockScreen.add(clockTime);
+  clockScreen.add(clockStatus);
+  clockTabs.addTo(clockScreen, clockTabs.clock);
+
+  weatherTemp.setFont(&FreeSansBold18pt7b);
+  weatherHiLo.setFont(&FreeSans12pt7b);
+  weatherDesc.setFont(&FreeSans12pt7b);
+  weatherHumidity.setFont(&FreeSans9pt7b);
+  weatherFeels.setFont(&FreeSans9pt7b);
+  weatherWind.setFont(&FreeSans9pt7b);
+  weatherScreen.add(weatherTemp);
+  weatherScreen.add(weatherHiLo);
+  weatherScreen.add(weatherDesc);
+  weatherScreen.add(weatherHumidity);
+  weatherScreen.add(weatherFeels);
+  weatherScreen.add(weatherWind);
+  weatherScreen.add(weatherIcon);
+  weatherTabs.addTo(weatherScreen, weatherTabs.weather);
+
+  irCenter.setTextSize(2);
+  irScreen.add(irView);
+  irScreen.add(irCross);
+  irScreen.add(irCenter);
+  irScreen.add(irMax);
+  irScreen.add(irMin);
+  irScreen.add(irTrend);
+  irTabs.addTo(irScreen, irTabs.ir);
+}
+
+void showPage(Page page) {
+  activePage = page;
+  switch (page) {
+    case PAGE_CLOCK:   compositor.show(clockScreen); break;
+    case PAGE_WEATHER: compositor.show(weatherScreen); break;
+    case PAGE_IR:      compositor.show(irScreen); break;
+  }
+}
+
+// -------------------------------------------------------------------
+// SETUP
+// -------------------------------------------------------------------
+void setup() {
+  Serial.begin(115200);
+  logger::begin(Serial);
+
+  initializeDisplay();
+  buildScreens();
+  showPage(PAGE_CLOCK);
+  compositor.update();
+
+  initializeSensor();
+  connectWiFi();
+
+  if (WiFi.status() == WL_CONNECTED) fetchWeather();
+}
+
+// -------------------------------------------------------------------
+// LOOP
+// -------------------------------------------------------------------
+void loop() {
+  readTouch();
+
+  updateClock();
+  updateWeather();
+  if (activePage == PAGE_IR) updateThermal();
+
+  // Repaint only the areas invalidated above; strips are DMA'd while the
+  // next one is composed
+  compositor.update();
+}
+
+// -------------------------------------------------------------------
+// HELPER FUNCTIONS
+// -------------------------------------------------------------------
+
+void initializeDisplay() {
+  tft.begin();
+  tft.setRotation(1); // Landscape
+  tft.fillScreen(ILI9341_BLACK);
+
+  ts.begin();
+  ts.setRotation(1);
+}
+
+void connectWiFi() {
+  WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
+  int attempts = 0;
+  while (WiFi.status() != WL_CONNECTED && attempts < 20) {
+    delay(500);
+    attempts++;
+  }
+
+  if (WiFi.status() == WL_CONNECTED) {
+    LOG_INFO("WiFi Connected after %d ms.", attempts * 500);
+    clockStatus.setColor(ILI9341_GREEN);
+    clockStatus.setText("WiFi Connected");
+  } else {
+    // Keep going offline: the IR page does not need the network
+    LOG_WARN("WiFi Failed after %d ms, continuing offline", attempts * 500);
+    clockStatus.setColor(ILI9341_RED);
+    clockStatus.setText("WiFi Failed!");
+  }
+}
+
+void initializeSensor() {
+  Wire.begin(I2C_SDA, I2C_SCL);
+  Wire.setClock(400000); // 400 KHz I2C speed
+
+  if (!mlx.begin(MLX90640_I2C_ADDR, &Wire)) {
+    LOG_ERROR("MLX90640 not found!");
+    irCenter.setText("N/A");
+    return;
+  }
+
+  mlx.setRefreshRate(MLX90640_4_HZ);
+  mlx.setMode(MLX90640_INTERLEAVED);
+  sensorReady = true;
+}
+
+void readTouch() {
+  bool pressed = false;
+  int x = 0, y = 0;
+
+  if (ts.tirqTouched() || ts.touched()) {
+    TouchPoint p = ts.getPoint();
+    if (p.z > MIN_PRESSURE) {
+      pressed = true;
+      x = map(p.y, TS_MINY, TS_MAXY, tft.width(), 0);
+      y = map(p.x, TS_MINX, TS_MAXX, tft.height(), 0);
+    }
+  }
+  compositor.touch(pressed, x, y);
+}
+
+void updateClock() {
+  if (WiFi.status() != WL_CONNECTED) return;
+
+  if (!ntpStarted) {
+    timeClient.begin();
+    ntpStarted = true;
+  }
+
+  // NTPClient only hits the network every 60 seconds; the label only
+  // invalidates when the formatted text differs, i.e. once a second
+  timeClient.update();
+  clockTime.setText(timeClient.getFormattedTime().c_str());
+}
+
+void updateWeather() {
+  static unsigned long last_update = 0;
+  if (millis() - last_update < WEATHER_INTERVAL_MS) return;
+  last_update = millis();
+
+  if (WiFi.status() == WL_CONNECTED) fetchWeather();
+}
+
+void updateThermal() {
+  if (!sensorReady) return;
+
+  // getFrame returns 0 on success
+  if (mlx.getFrame(frame) != 0) {
+    LOG_WARN("Failed to read from sensor");
+    return;
+  }
+
+  float minTemp = 1000.0;
+  float maxTemp = -1000.0;
+  for (int i = 0; i < 768; i++) {
+    float t = frame[i];
+    if (t < minTemp) minTemp = t;
+    if (t > maxTemp) maxTemp = t;
+  }
+  if ((maxTemp - minTemp) < 1.0) maxTemp = minTemp + 1.0;
+
+  // Center is roughly row 12, col 16
+  float centerTemp = frame[12 * 32 + 16];
+
+  irView.setFrame(frame, minTemp, maxTemp);
+  irCenter.setValue(centerTemp);
+  irMax.setValue(maxTemp);
+  irMin.setValue(minTemp);
+  irTrend.push(centerTemp);
+}
+
+bool fetchWeather() {
+  HTTPClient http;
+
+  String serverPath = "http://api.openweathermap.org/data/2.5/weather?";
+  serverPath += "lat=" + String(LATITUDE);
+  serverPath += "&lon=" + String(LONGITUDE);
+  serverPath += "&units=" + String(WEATHER_UNIT);
+  serverPath += "&lang=" + String(WEATHER_LANGUAGE);
+  serverPath += "&appid=" + String(OPENWEATHERMAP_API_KEY);
+
+  http.begin(serverPath.c_str());
+  int httpResponseCode = http.GET();
+  if (httpResponseCode <= 0) {
+    LOG_ERROR("HTTP Error: %s", http.errorToString(httpResponseCode).c_str());
+    http.end();
+    weatherDesc.setText("Failed to get weather.");
+    return false;
+  }
+
+  String payload = http.getString();
+  http.end();
+
+  StaticJsonDocument<4096> doc;
+  DeserializationError error = deserializeJson(doc, payload);
+  if (error) {
+    LOG_ERROR("deserializeJson() failed: %s", error.c_str());
+    return false;
+  }
+
+  const char* unit = tempUnit();
+  char text[UI_TEXT_MAX];
+
+  float temp = doc["main"]["temp"].as<float>();
+  snprintf(text, sizeof(text), "%.1f%s", temp, unit);
+  weatherTemp.setText(text);
+
+  float temp_min = doc["main"]["temp_min"].as<float>();
+  float temp_max = doc["main"]["temp_max"].as<float>();
+  snprintf(text, sizeof(text), "H: %.0f%s | L: %.0f%s", temp_max, unit, temp_min, unit);
+  weatherHiLo.setText(text);
+
+  String description = doc["weather"][0]["description"].as<String>();
+  description.toUpperCase();
+  weatherDesc.setText(description.c_str());
+  weatherIcon.setCode(doc["weather"][0]["icon"].as<String>());
+
+  weatherHumidity.setValue(doc["main"]["humidity"].as<float>());
+  weatherFeels.setValue(doc["main"]["feels_like"].as<float>());
+
+  // 1 m/s = 3.6 km/h; imperial is already mph, standard stays m/s
+  float wind = doc["wind"]["speed"].as<float>();
+  bool metric = strcmp(WEATHER_UNIT, "metric") == 0;
+  weatherWind.setValue(metric ? wind * 3.6 : wind);
+
+  return true;
+}
@@ -0,0 +1,21 @@
+// -------------------------------------------------------------------
+// 1. WiFi and API Configuration
+// -------------------------------------------------------------------
+
+// Replace with your network credentials
+#define WIFI_SSID       ""
+#define WIFI_PASSWORD   ""
+
+// OpenWeatherMap API Key
+// Get a free API key from https://openweathermap.org/api
+#define OPENWEATHERMAP_API_KEY ""
+
+// Location Coordinates (Example: New York City)
+// Look up your location's latitude and longitude here: https://latlong.net/
+#define LATITUDE   "44.670036" 
+#define LONGITUDE "-63.577577"
+
+// Timezone offset (e.g., Eastern Standard Time is -5, London is 0)
+// This is used for NTP time synchronization.
+#define TIMEZONE_OFFSET_HRS -4
+// -------------------------------------------------------------------
\ No newline at end of file
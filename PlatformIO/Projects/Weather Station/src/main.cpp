@@ -3,8 +3,8 @@
 #include <HTTPClient.h>
 #include <ArduinoJson.h>
 #include <Adafruit_GFX.h>
-#include <Adafruit_ILI9341.h>
-#include <SPI.h>
+#include <TFTDisplay.h>
+#include <Logger.h>
 
 // --- CUSTOM FONTS FOR SMOOTH TEXT ---
 // These fonts are included with the Adafruit GFX library and provide a much cleaner appearance.
@@ -13,23 +13,15 @@
 #include <Fonts/FreeSans12pt7b.h>     // Medium font for description and titles
 
 // --- DISPLAY PIN DEFINITIONS (ILI9341) ---
-// Note: We are using the pins confirmed in our previous steps.
-#define TFT_CS    10
-#define TFT_DC    8
-#define TFT_RST   4
-#define TFT_MOSI  11 // Shared Data
-#define TFT_SCK   12 // Shared Clock
+// Shared by all projects, see TFTPins.h in PlatformIO/lib/TFTDisplay.
 
 // --- WEATHER API CONSTANTS ---
 // We use metric for simplicity, change to 'imperial' for Fahrenheit
 const char* WEATHER_UNIT = "metric"; 
 const char* WEATHER_LANGUAGE = "en";
 
-// Define the SPI Settings used by the ILI9341 display
-SPISettings settingsA(40000000, MSBFIRST, SPI_MODE0); 
-
-// Initialize the display
-Adafruit_ILI9341 tft = Adafruit_ILI9341(TFT_CS, TFT_DC, TFT_MOSI, TFT_SCK, TFT_RST);
+// Initialize the display (hardware SPI with DMA, 40 MHz)
+TFTDisplay tft;
 
 // --- STRUCTURES FOR DATA ---
 struct WeatherData {
@@ -62,8 +54,9 @@ void drawWeatherIcon(const String& icon_code, int x, int y, int color);
 
 void setup() {
   Serial.begin(115200);
+  logger::begin(Serial);
   
-  // 1. Initialize Display (with SPI synchronization fix)
+  // 1. Initialize Display
   initializeDisplay();
   // Using the built-in font size 2 for the startup message
   tft.setTextSize(2); 
@@ -82,7 +75,7 @@ void setup() {
   tft.println("Fetching weather...");
   
   if (fetchWeatherData(current_weather)) {
-    Serial.println("Weather data fetched successfully.");
+    LOG_INFO("Weather data fetched successfully.");
     displayWeatherData(current_weather);
   } else {
     tft.println("\nFailed to get weather.");
@@ -118,9 +111,7 @@ void loop() {
 // -------------------------------------------------------------------
 
 void initializeDisplay() {
-  // This is the critical SPI synchronization fix from the last step
-  SPI.begin();
-  SPI.beginTransaction(settingsA); 
+  // The driver owns the SPI bus, no manual transactions needed
   tft.begin();
   tft.setRotation(1); // Landscape mode (320x240)
   tft.fillScreen(ILI9341_BLACK); 
@@ -129,11 +120,9 @@ void initializeDisplay() {
   // We use setTextSize(1) here as a baseline; custom fonts ignore setTextSize.
   tft.setTextSize(1);
   tft.setCursor(10, 10);
-  SPI.endTransaction();
 }
 
 void connectWiFi() {
-  SPI.beginTransaction(settingsA); 
   tft.fillScreen(ILI9341_BLACK);
   tft.setCursor(10, 10);
   tft.setTextColor(ILI9341_YELLOW);
@@ -168,12 +157,11 @@ void connectWiFi() {
     // Halt and allow user to restart/check wiring
     while(true); 
   }
-  SPI.endTransaction();
 }
 
 bool fetchWeatherData(WeatherData& data) {
   if (WiFi.status() != WL_CONNECTED) {
-    Serial.println("Not connected to Wi-Fi. Cannot fetch weather.");
+    LOG_WARN("Not connected to Wi-Fi. Cannot fetch weather.");
     return false;
   }
 
@@ -187,27 +175,27 @@ bool fetchWeatherData(WeatherData& data) {
   serverPath += "&lang=" + String(WEATHER_LANGUAGE);
   serverPath += "&appid=" + String(OPENWEATHERMAP_API_KEY);
 
-  Serial.print("Requesting: ");
-  Serial.println(serverPath);
+  // Log the request without the API key
+  String loggedPath = serverPath.substring(0, serverPath.indexOf("&appid=") + 7) + "<redacted>";
+  LOG_INFO("Requesting: %s", loggedPath.c_str());
 
   // Begin HTTP request
   http.begin(serverPath.c_str());
   int httpResponseCode = http.GET();
 
   if (httpResponseCode > 0) {
-    Serial.printf("HTTP Response code: %d\n", httpResponseCode);
+    LOG_INFO("HTTP Response code: %d", httpResponseCode);
     
     // Check if JSON payload is received
     String payload = http.getString();
-    Serial.println("Received payload.");
+    LOG_INFO("Received payload.");
 
     // Use StaticJsonDocument for parsing
     StaticJsonDocument<4096> doc; 
     DeserializationError error = deserializeJson(doc, payload);
 
     if (error) {
-      Serial.print(F("deserializeJson() failed: "));
-      Serial.println(error.f_str());
+      LOG_ERROR("deserializeJson() failed: %s", error.c_str());
       http.end();
       return false;
     }
@@ -228,14 +216,13 @@ bool fetchWeatherData(WeatherData& data) {
     http.end();
     return true;
   } else {
-    Serial.printf("HTTP Error: %s\n", http.errorToString(httpResponseCode).c_str());
+    LOG_ERROR("HTTP Error: %s", http.errorToString(httpResponseCode).c_str());
     http.end();
     return false;
   }
 }
 
 void displayWeatherData(const WeatherData& data) {
-  SPI.beginTransaction(settingsA); 
   tft.fillScreen(ILI9341_BLACK);
 
   // --- 2. CURRENT TEMPERATURE (Using FreeSansBold18pt7b) ---
@@ -324,8 +311,6 @@ void displayWeatherData(const WeatherData& data) {
   tft.println(wind_unit_string);
   
   // --- 6. LAST UPDATED TIME (REMOVED) ---
-
-  SPI.endTransaction();
 }
 
 // Simple icon drawing function based on OpenWeatherMap icon codes
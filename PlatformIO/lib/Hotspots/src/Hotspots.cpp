@@ -0,0 +1,213 @@
+#include "Hotspots.h"
+
+namespace hotspots {
+
+Tracker::Tracker() : _labels(0), _count(0) {
+  reset();
+}
+
+void Tracker::reset() {
+  memset(_tracks, 0, sizeof(_tracks));
+  _nextId = 1;
+  _count = 0;
+}
+
+uint8_t Tracker::update(const float* frame, float threshold) {
+  label(frame, threshold);
+  collect();
+  track();
+  return _count;
+}
+
+// -------------------------------------------------------------------
+// LABELING
+// -------------------------------------------------------------------
+
+// Root of a label's set, halving the path on the way up
+uint16_t Tracker::find(uint16_t label) {
+  while (_parent[label] != label) {
+    _parent[label] = _parent[_parent[label]];
+    label = _parent[label];
+  }
+  return label;
+}
+
+// Joins two sets under the lower root and folds the other's statistics in
+void Tracker::unite(uint16_t a, uint16_t b) {
+  a = find(a);
+  b = find(b);
+  if (a == b) return;
+  if (b < a) {
+    uint16_t t = a;
+    a = b;
+    b = t;
+  }
+  _parent[b] = a;
+
+  Region& ra = _regions[a];
+  const Region& rb = _regions[b];
+  ra.area += rb.area;
+  ra.sumX += rb.sumX;
+  ra.sumY += rb.sumY;
+  ra.sum += rb.sum;
+  if (rb.peak > ra.peak) ra.peak = rb.peak;
+  if (rb.x0 < ra.x0) ra.x0 = rb.x0;
+  if (rb.y0 < ra.y0) ra.y0 = rb.y0;
+  if (rb.x1 > ra.x1) ra.x1 = rb.x1;
+  if (rb.y1 > ra.y1) ra.y1 = rb.y1;
+}
+
+// One raster pass. Only the left, up-left, up and up-right neighbours are
+// labeled yet; up touches the other three, so if it is hot it already
+// carries their set, and otherwise only up-right can bring a new one.
+void Tracker::label(const float* frame, float threshold) {
+  _labels = 0;
+  memset(_rows[1], 0, sizeof(_rows[1])); // row 0's "up"
+
+  for (uint8_t y = 0; y < HOTSPOTS_HEIGHT; y++) {
+    const uint16_t* up = _rows[(y + 1) & 1];
+    uint16_t* row = _rows[y & 1];
+    const float* pixels = frame + y * HOTSPOTS_WIDTH;
+
+    for (uint8_t x = 0; x < HOTSPOTS_WIDTH; x++) {
+      float t = pixels[x];
+      if (!(t >= threshold)) { // NaN (a bad pixel) is background too
+        row[x] = 0;
+        continue;
+      }
+
+      uint16_t l;
+      uint16_t upRight = x + 1 < HOTSPOTS_WIDTH ? up[x + 1] : 0;
+      if (up[x]) {
+        l = up[x];
+      } else {
+        uint16_t before = x ? (row[x - 1] ? row[x - 1] : up[x - 1]) : 0;
+        if (upRight) {
+          l = upRight;
+          if (before) unite(before, upRight);
+        } else if (before) {
+          l = before;
+        } else {
+          l = ++_labels;
+          _parent[l] = l;
+          _regions[l] = { 0, 0, 0, 0, t, x, y, x, y };
+        }
+      }
+      row[x] = l;
+
+      Region& r = _regions[find(l)];
+      r.area++;
+      r.sumX += x;
+      r.sumY += y;
+      r.sum += t;
+      if (t > r.peak) r.peak = t;
+      if (x < r.x0) r.x0 = x;
+      if (x > r.x1) r.x1 = x;
+      if (y > r.y1) r.y1 = y; // rows only grow
+    }
+  }
+}
+
+// Keeps the HOTSPOTS_MAX_BLOBS hottest roots, sorted by peak
+void Tracker::collect() {
+  _count = 0;
+  for (uint16_t l = 1; l <= _labels; l++) {
+    if (_parent[l] != l) continue;
+    const Region& r = _regions[l];
+    if (r.area < HOTSPOTS_MIN_AREA) continue;
+
+    uint8_t i = _count < HOTSPOTS_MAX_BLOBS ? _count++ : HOTSPOTS_MAX_BLOBS;
+    while (i > 0 && _blobs[i - 1].peak < r.peak) {
+      if (i < HOTSPOTS_MAX_BLOBS) _blobs[i] = _blobs[i - 1];
+      i--;
+    }
+    if (i == HOTSPOTS_MAX_BLOBS) continue; // cooler than everything kept
+
+    Blob& b = _blobs[i];
+    b.id = 0;
+    b.age = 0;
+    b.area = r.area;
+    b.peak = r.peak;
+    b.mean = r.sum / r.area;
+    b.cx = (float)r.sumX / r.area;
+    b.cy = (float)r.sumY / r.area;
+    b.x0 = r.x0;
+    b.y0 = r.y0;
+    b.x1 = r.x1;
+    b.y1 = r.y1;
+  }
+}
+
+// -------------------------------------------------------------------
+// TRACKING
+// -------------------------------------------------------------------
+
+// Greedy nearest-centroid association: the closest blob/track pair within
+// HOTSPOTS_MATCH_DISTANCE is matched first, then the next closest, ...
+void Tracker::track() {
+  const float gate = HOTSPOTS_MATCH_DISTANCE * HOTSPOTS_MATCH_DISTANCE;
+  bool trackMatched[HOTSPOTS_MAX_TRACKS] = {};
+
+  for (;;) {
+    float best = gate;
+    int8_t bestBlob = -1, bestTrack = -1;
+    for (uint8_t b = 0; b < _count; b++) {
+      if (_blobs[b].id) continue;
+      for (uint8_t t = 0; t < HOTSPOTS_MAX_TRACKS; t++) {
+        if (!_tracks[t].id || trackMatched[t]) continue;
+        float dx = _blobs[b].cx - _tracks[t].cx;
+        float dy = _blobs[b].cy - _tracks[t].cy;
+        float d = dx * dx + dy * dy;
+        if (d <= best) {
+          best = d;
+          bestBlob = b;
+          bestTrack = t;
+        }
+      }
+    }
+    if (bestBlob < 0) break;
+
+    Track& t = _tracks[bestTrack];
+    Blob& b = _blobs[bestBlob];
+    trackMatched[bestTrack] = true;
+    if (t.age < 255) t.age++;
+    t.missed = 0;
+    t.cx = b.cx;
+    t.cy = b.cy;
+    b.id = t.id;
+    b.age = t.age;
+  }
+
+  // Tracks that found nothing fade out after a few frames
+  for (uint8_t t = 0; t < HOTSPOTS_MAX_TRACKS; t++) {
+    if (_tracks[t].id && !trackMatched[t] && ++_tracks[t].missed > HOTSPOTS_MAX_MISSED) {
+      _tracks[t].id = 0;
+    }
+  }
+
+  // Blobs left over start new tracks while there are free slots
+  for (uint8_t b = 0; b < _count; b++) {
+    if (_blobs[b].id) continue;
+    for (uint8_t t = 0; t < HOTSPOTS_MAX_TRACKS; t++) {
+      if (_tracks[t].id) continue;
+      uint8_t id = newId();
+      _tracks[t] = { id, 1, 0, _blobs[b].cx, _blobs[b].cy };
+      _blobs[b].id = id;
+      _blobs[b].age = 1;
+      break;
+    }
+  }
+}
+
+// Next id in 1..255 that no live track holds
+uint8_t Tracker::newId() {
+  for (;;) {
+    uint8_t id = _nextId;
+    if (++_nextId == 0) _nextId = 1;
+    bool taken = false;
+    for (uint8_t t = 0; t < HOTSPOTS_MAX_TRACKS; t++) taken |= _tracks[t].id == id;
+    if (!taken) return id;
+  }
+}
+
+} // namespace hotspots
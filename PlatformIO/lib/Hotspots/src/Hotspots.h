@@ -0,0 +1,121 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Hot-region detection and tracking for low-resolution thermal frames.
+//
+//   hotspots::Tracker tracker;
+//   ...
+//   mlx.getFrame(frame);
+//   uint8_t n = tracker.update(frame, 30.0);   // pixels >= 30 C
+//   for (uint8_t i = 0; i < n; i++) {
+//     const hotspots::Blob& b = tracker[i];    // hottest first
+//     ...b.id, b.peak, b.x0..b.y1...
+//   }
+//
+// update() labels 8-connected regions in one raster pass: provisional
+// labels are joined with a union-find and each pixel's statistics go
+// straight into its set's root, so nothing is revisited. Regions are then
+// matched to the previous frame's by nearest centroid, which keeps their
+// ids stable while they move.
+//
+// All state lives in the Tracker (about 10 KB for 32x24); nothing is
+// allocated per frame.
+
+#ifndef HOTSPOTS_WIDTH
+#define HOTSPOTS_WIDTH 32
+#endif
+#ifndef HOTSPOTS_HEIGHT
+#define HOTSPOTS_HEIGHT 24
+#endif
+
+// Regions reported per frame (the hottest are kept) and tracks remembered
+#ifndef HOTSPOTS_MAX_BLOBS
+#define HOTSPOTS_MAX_BLOBS 8
+#endif
+#ifndef HOTSPOTS_MAX_TRACKS
+#define HOTSPOTS_MAX_TRACKS 8
+#endif
+
+// Regions smaller than this (pixels) are treated as noise
+#ifndef HOTSPOTS_MIN_AREA
+#define HOTSPOTS_MIN_AREA 2
+#endif
+
+// Furthest a centroid may move between frames and still be the same
+// region (sensor pixels), and how many frames a track survives unmatched
+#ifndef HOTSPOTS_MATCH_DISTANCE
+#define HOTSPOTS_MATCH_DISTANCE 4.0f
+#endif
+#ifndef HOTSPOTS_MAX_MISSED
+#define HOTSPOTS_MAX_MISSED 2
+#endif
+
+// A new label needs a background pixel to its left, so a row holds at most
+// half its width in new labels
+#define HOTSPOTS_MAX_LABELS ((HOTSPOTS_WIDTH + 1) / 2 * HOTSPOTS_HEIGHT)
+
+namespace hotspots {
+
+struct Blob {
+  uint8_t id;              // track id, stable across frames (0 if no track slot was free)
+  uint8_t age;             // frames the track has been matched, saturating at 255
+  uint16_t area;           // pixels
+  float peak;              // hottest pixel
+  float mean;              // average over the region
+  float cx, cy;            // centroid, in sensor pixels
+  uint8_t x0, y0, x1, y1;  // bounding box, inclusive
+};
+
+class Tracker {
+public:
+  Tracker();
+
+  // Labels the pixels of `frame` (HOTSPOTS_WIDTH x HOTSPOTS_HEIGHT, row
+  // major) at or above `threshold`, measures each region and matches it to
+  // the previous frame's. Returns the number of blobs, hottest first.
+  uint8_t update(const float* frame, float threshold);
+
+  uint8_t count() const { return _count; }
+  const Blob& operator[](uint8_t i) const { return _blobs[i]; }
+
+  // Forgets every track (ids restart at 1).
+  void reset();
+
+private:
+  // Running statistics of one label; only meaningful at a set's root
+  struct Region {
+    uint16_t area;
+    uint32_t sumX, sumY;
+    float sum;
+    float peak;
+    uint8_t x0, y0, x1, y1;
+  };
+
+  struct Track {
+    uint8_t id;   // 0 = free slot
+    uint8_t age;
+    uint8_t missed;
+    float cx, cy;
+  };
+
+  uint16_t find(uint16_t label);
+  void unite(uint16_t a, uint16_t b);
+  void label(const float* frame, float threshold);
+  void collect();
+  void track();
+  uint8_t newId();
+
+  uint16_t _parent[HOTSPOTS_MAX_LABELS + 1]; // label 0 is background
+  Region _regions[HOTSPOTS_MAX_LABELS + 1];
+  uint16_t _labels;
+  uint16_t _rows[2][HOTSPOTS_WIDTH]; // labels of the previous and current row
+
+  Blob _blobs[HOTSPOTS_MAX_BLOBS];
+  uint8_t _count;
+
+  Track _tracks[HOTSPOTS_MAX_TRACKS];
+  uint8_t _nextId;
+};
+
+} // namespace hotspots
@@ -0,0 +1,480 @@
+#include "IRStream.h"
+#include <atomic>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Plain BSD sockets: lwIP provides the same calls on the ESP32 (close(),
+// fcntl() and select() go through the VFS layer)
+#if defined(ARDUINO_ARCH_ESP32)
+#include <lwip/sockets.h>
+#else
+#include <chrono>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <thread>
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace irstream {
+
+#define BITMAP_BYTES (IRSTREAM_PIXELS / 8)
+#define PING_SIZE    (IRSTREAM_HEADER + 4)
+#define PONG_SIZE    (IRSTREAM_HEADER + 8)
+
+struct Frame {
+  uint32_t seq;
+  uint32_t captureUs;
+  int16_t values[IRSTREAM_PIXELS];
+};
+
+struct Client {
+  int fd;                                 // -1 = free slot
+  bool hasReference;
+  int16_t reference[IRSTREAM_PIXELS];     // what the client will have once `out` is through
+  uint32_t lastSeq;
+  uint8_t out[IRSTREAM_MESSAGE_MAX];      // message being sent
+  uint16_t outLength, outSent;
+  uint8_t pong[2 * PONG_SIZE];            // replies owed to PINGs, sent after `out`:
+  uint8_t pongLength;                     //   the rest of one under way, then the newest
+  uint8_t in[PING_SIZE];                  // partial PING
+  uint8_t inLength;
+};
+
+// Triple buffer between publish() and the sender task. `middle` holds the
+// index of the buffer neither side owns, plus FRESH when it holds a frame
+// the task has not taken yet.
+#define FRESH 0x80
+
+static Frame frames[3];
+static uint8_t back = 0;   // publish() writes here
+static uint8_t front = 1;  // the sender task reads here
+static std::atomic<uint8_t> middle(2);
+static uint32_t published = 0;
+
+static int listener = -1;
+static uint16_t listenPort = 0;
+static Client clientSlots[IRSTREAM_MAX_CLIENTS];
+static std::atomic<uint8_t> clientCount(0);
+static std::atomic<uint32_t> dropCount(0);
+
+// Last value publish() sent for each pixel, standing in for NaNs
+static int16_t lastValues[IRSTREAM_PIXELS];
+
+static int16_t quantize(float t, int16_t previous) {
+  // NaN (a bad pixel): 0 C would stretch the keyframe range and force it wide
+  if (!(t == t)) return previous;
+  float q = t * (1000.0f / IRSTREAM_STEP_MC);
+  if (q > 32767) return 32767;
+  if (q < -32768) return -32768;
+  return (int16_t)lroundf(q);
+}
+
+// -------------------------------------------------------------------
+// PUBLISHING (loop task)
+// -------------------------------------------------------------------
+
+uint32_t nowMicros() {
+#if defined(ARDUINO_ARCH_ESP32)
+  return micros();
+#else
+  // Host builds: real time, not the simulator's clock (which jumps ahead
+  // during sensor waits), so loopback latency means something
+  auto now = std::chrono::steady_clock::now().time_since_epoch();
+  return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(now).count();
+#endif
+}
+
+void publish(const float* frame) {
+  Frame& f = frames[back];
+  f.seq = ++published;
+  f.captureUs = nowMicros();
+  for (uint16_t i = 0; i < IRSTREAM_PIXELS; i++) lastValues[i] = f.values[i] = quantize(frame[i], lastValues[i]);
+
+  back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & ~FRESH;
+}
+
+uint8_t clients() {
+  return clientCount.load(std::memory_order_relaxed);
+}
+
+uint32_t dropped() {
+  return dropCount.load(std::memory_order_relaxed);
+}
+
+// -------------------------------------------------------------------
+// ENCODING
+// -------------------------------------------------------------------
+
+static inline void put16(uint8_t* p, uint16_t v) {
+  p[0] = v & 0xFF;
+  p[1] = v >> 8;
+}
+
+static inline void put32(uint8_t* p, uint32_t v) {
+  put16(p, v & 0xFFFF);
+  put16(p + 2, v >> 16);
+}
+
+static size_t header(uint8_t* out, uint8_t type, uint8_t flags, uint16_t length) {
+  out[0] = IRSTREAM_SYNC0;
+  out[1] = IRSTREAM_SYNC1;
+  out[2] = type;
+  out[3] = flags;
+  put16(out + 4, length);
+  return IRSTREAM_HEADER;
+}
+
+static size_t encodeHello(uint8_t* out) {
+  uint8_t* p = out + header(out, IRSTREAM_HELLO, 0, 6);
+  p[0] = IRSTREAM_VERSION;
+  p[1] = IRSTREAM_WIDTH;
+  p[2] = IRSTREAM_HEIGHT;
+  p[3] = 0;
+  put16(p + 4, IRSTREAM_STEP_MC);
+  return IRSTREAM_HEADER + 6;
+}
+
+static size_t keyframeSize(const Frame& f, int16_t* base, bool* wide) {
+  int16_t lo = f.values[0], hi = f.values[0];
+  for (uint16_t i = 1; i < IRSTREAM_PIXELS; i++) {
+    if (f.values[i] < lo) lo = f.values[i];
+    if (f.values[i] > hi) hi = f.values[i];
+  }
+  *base = lo;
+  *wide = hi - lo > 255;
+  return IRSTREAM_HEADER + 10 + IRSTREAM_PIXELS * (*wide ? 2 : 1);
+}
+
+static size_t encodeKeyframe(uint8_t* out, const Frame& f, int16_t base, bool wide) {
+  uint16_t length = 10 + IRSTREAM_PIXELS * (wide ? 2 : 1);
+  uint8_t* p = out + header(out, IRSTREAM_KEYFRAME, wide ? IRSTREAM_FLAG_WIDE : 0, length);
+  put32(p, f.seq);
+  put32(p + 4, f.captureUs);
+  put16(p + 8, base);
+  p += 10;
+  for (uint16_t i = 0; i < IRSTREAM_PIXELS; i++) {
+    uint16_t v = f.values[i] - base;
+    if (wide) {
+      put16(p, v);
+      p += 2;
+    } else {
+      *p++ = v;
+    }
+  }
+  return IRSTREAM_HEADER + length;
+}
+
+static size_t deltaSize(const Frame& f, const int16_t* reference) {
+  uint16_t changed = 0, escaped = 0;
+  for (uint16_t i = 0; i < IRSTREAM_PIXELS; i++) {
+    int d = f.values[i] - reference[i];
+    if (d == 0) continue;
+    changed++;
+    if (d < -7 || d > 7) escaped++;
+  }
+  return IRSTREAM_HEADER + 8 + BITMAP_BYTES + (changed + 1) / 2 + escaped * 2;
+}
+
+static size_t encodeDelta(uint8_t* out, size_t size, const Frame& f, const int16_t* reference) {
+  uint8_t* p = out + header(out, IRSTREAM_DELTA, 0, size - IRSTREAM_HEADER);
+  put32(p, f.seq);
+  put32(p + 4, f.captureUs);
+
+  uint8_t* bitmap = p + 8;
+  uint8_t* codes = bitmap + BITMAP_BYTES;
+  memset(bitmap, 0, BITMAP_BYTES);
+
+  // Escapes go after the codes, so count the codes first
+  uint16_t changed = 0;
+  for (uint16_t i = 0; i < IRSTREAM_PIXELS; i++) changed += f.values[i] != reference[i];
+  uint8_t* escapes = codes + (changed + 1) / 2;
+  memset(codes, 0, escapes - codes);
+
+  uint16_t n = 0;
+  for (uint16_t i = 0; i < IRSTREAM_PIXELS; i++) {
+    int d = f.values[i] - reference[i];
+    if (d == 0) continue;
+    bitmap[i >> 3] |= 1 << (i & 7);
+
+    uint8_t code;
+    if (d >= -7 && d <= 7) {
+      code = d + 7;
+    } else {
+      code = 15;
+      put16(escapes, f.values[i]);
+      escapes += 2;
+    }
+    codes[n >> 1] |= (n & 1) ? code << 4 : code;
+    n++;
+  }
+  return size;
+}
+
+// Queues the newest frame for a client: a delta if it is smaller than a
+// keyframe, counting the frames it never saw
+static void encodeFrame(Client& c, const Frame& f) {
+  int16_t base;
+  bool wide;
+  size_t key = keyframeSize(f, &base, &wide);
+  size_t delta = c.hasReference ? deltaSize(f, c.reference) : SIZE_MAX;
+
+  if (delta < key) {
+    c.outLength = encodeDelta(c.out, delta, f, c.reference);
+  } else {
+    c.outLength = encodeKeyframe(c.out, f, base, wide);
+  }
+  c.outSent = 0;
+
+  if (c.lastSeq && f.seq - c.lastSeq > 1) dropCount.fetch_add(f.seq - c.lastSeq - 1, std::memory_order_relaxed);
+  c.lastSeq = f.seq;
+  memcpy(c.reference, f.values, sizeof(c.reference));
+  c.hasReference = true;
+}
+
+// -------------------------------------------------------------------
+// SOCKETS (sender task)
+// -------------------------------------------------------------------
+
+static bool setNonBlocking(int fd) {
+  int flags = fcntl(fd, F_GETFL, 0);
+  return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+static void dropClient(Client& c) {
+  close(c.fd);
+  c.fd = -1;
+  clientCount.fetch_sub(1, std::memory_order_relaxed);
+}
+
+static void acceptClients() {
+  for (;;) {
+    int fd = accept(listener, nullptr, nullptr);
+    if (fd < 0) return;
+
+    Client* c = nullptr;
+    for (uint8_t i = 0; i < IRSTREAM_MAX_CLIENTS && !c; i++) {
+      if (clientSlots[i].fd < 0) c = &clientSlots[i];
+    }
+    if (!c || !setNonBlocking(fd)) {
+      close(fd);
+      continue;
+    }
+
+    // Frames are small and latency matters more than packet count
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    // Keep the kernel from queueing frames on our behalf: once a couple are
+    // in flight, send() reports EAGAIN and newer frames replace older ones
+    // here instead. (lwIP ignores this; its send buffer is a few KB anyway.)
+    int sendBuffer = IRSTREAM_SEND_BUFFER;
+    setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &sendBuffer, sizeof(sendBuffer));
+
+    c->fd = fd;
+    c->hasReference = false;
+    c->lastSeq = 0;
+    c->outLength = encodeHello(c->out);
+    c->outSent = 0;
+    c->pongLength = 0;
+    c->inLength = 0;
+    clientCount.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+// Sends as much of `buf` as the socket takes without waiting. Returns false
+// if the connection is gone.
+static bool sendSome(Client& c, const uint8_t* buf, uint16_t length, uint16_t& sent) {
+  while (sent < length) {
+    ssize_t n = send(c.fd, buf + sent, length - sent, MSG_DONTWAIT | MSG_NOSIGNAL);
+    if (n > 0) {
+      sent += n;
+    } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      return true;
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Finishes the current message, then any PONG owed. PONGs never cut into
+// a frame, so their latency is at most one frame's transfer.
+static bool flush(Client& c) {
+  if (c.outSent < c.outLength) {
+    if (!sendSome(c, c.out, c.outLength, c.outSent)) return false;
+    if (c.outSent < c.outLength) return true;
+  }
+  if (c.pongLength) {
+    uint16_t sent = 0;
+    if (!sendSome(c, c.pong, c.pongLength, sent)) return false;
+    // A PONG is small; if the socket took only part of it, send the rest next time
+    memmove(c.pong, c.pong + sent, c.pongLength - sent);
+    c.pongLength -= sent;
+  }
+  return true;
+}
+
+// Queues a PONG behind the rest of one already under way. One that has not
+// started going out is replaced: the newer round trip is the better sample.
+static void answerPing(Client& c, const uint8_t* token) {
+  uint8_t at = c.pongLength >= PONG_SIZE ? c.pongLength - PONG_SIZE : c.pongLength;
+  uint8_t* p = c.pong + at + header(c.pong + at, IRSTREAM_PONG, 0, 8);
+  memcpy(p, token, 4);
+  put32(p + 4, nowMicros());
+  c.pongLength = at + PONG_SIZE;
+}
+
+// Where the input's first sync marker starts. A trailing SYNC0 counts: its
+// SYNC1 may come with the next read.
+static uint8_t syncOffset(const Client& c) {
+  for (uint8_t i = 0; i < c.inLength; i++) {
+    if (c.in[i] == IRSTREAM_SYNC0 && (i + 1 == c.inLength || c.in[i + 1] == IRSTREAM_SYNC1)) return i;
+  }
+  return c.inLength;
+}
+
+// Reads PINGs; anything else from a client is skipped
+static bool receive(Client& c) {
+  for (;;) {
+    ssize_t n = recv(c.fd, c.in + c.inLength, sizeof(c.in) - c.inLength, MSG_DONTWAIT);
+    if (n == 0) return false;
+    if (n < 0) return errno == EAGAIN || errno == EWOULDBLOCK;
+    c.inLength += n;
+
+    // Resynchronise on the sync marker, keeping whatever follows it
+    for (;;) {
+      uint8_t skip = syncOffset(c);
+      c.inLength -= skip;
+      memmove(c.in, c.in + skip, c.inLength);
+      if (c.inLength < PING_SIZE) break;
+
+      if (c.in[2] == IRSTREAM_PING) {
+        answerPing(c, c.in + IRSTREAM_HEADER);
+        c.inLength = 0;
+      } else {
+        // Not a PING: look for the next marker past this one
+        c.inLength -= 2;
+        memmove(c.in, c.in + 2, c.inLength);
+      }
+    }
+  }
+}
+
+static void serve() {
+  // Take the newest frame if publish() left one
+  if (middle.load(std::memory_order_acquire) & FRESH) {
+    front = middle.exchange(front, std::memory_order_acq_rel) & ~FRESH;
+  }
+  const Frame& f = frames[front];
+
+  acceptClients();
+
+  fd_set readable, writable;
+  FD_ZERO(&readable);
+  FD_ZERO(&writable);
+  FD_SET(listener, &readable);
+  int maxFd = listener;
+
+  for (uint8_t i = 0; i < IRSTREAM_MAX_CLIENTS; i++) {
+    Client& c = clientSlots[i];
+    if (c.fd < 0) continue;
+
+    if (!receive(c)) {
+      dropClient(c);
+      continue;
+    }
+    // Only start a frame once the previous one is completely on its way
+    if (c.outSent == c.outLength && f.seq && f.seq != c.lastSeq) encodeFrame(c, f);
+    if (!flush(c)) {
+      dropClient(c);
+      continue;
+    }
+
+    FD_SET(c.fd, &readable);
+    if (c.outSent < c.outLength || c.pongLength) FD_SET(c.fd, &writable);
+    if (c.fd > maxFd) maxFd = c.fd;
+  }
+
+  // Sleep until a socket needs us or it is time to look for a new frame
+  timeval timeout = { 0, IRSTREAM_POLL_MS * 1000 };
+  select(maxFd + 1, &readable, &writable, nullptr, &timeout);
+}
+
+static bool openListener(uint16_t port) {
+  listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  if (listener < 0) return false;
+
+  int one = 1;
+  setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+  sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+#if defined(ARDUINO_ARCH_ESP32)
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+#else
+  // Host builds only serve the local client
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+#endif
+
+  if (bind(listener, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(listener, IRSTREAM_MAX_CLIENTS) != 0 ||
+      !setNonBlocking(listener)) {
+    close(listener);
+    listener = -1;
+    return false;
+  }
+
+  // Port 0 asks for any free one: find out which
+  socklen_t length = sizeof(addr);
+  getsockname(listener, (sockaddr*)&addr, &length);
+  listenPort = ntohs(addr.sin_port);
+  return true;
+}
+
+// -------------------------------------------------------------------
+// SENDER TASK
+// -------------------------------------------------------------------
+
+#if defined(ARDUINO_ARCH_ESP32)
+static void senderTask(void*) {
+  for (;;) serve();
+}
+
+static void startSender() {
+  // Keep the sockets off the loop task's core so they can't steal time slices
+#if CONFIG_FREERTOS_UNICORE
+  BaseType_t core = tskNO_AFFINITY;
+#else
+  BaseType_t core = ARDUINO_RUNNING_CORE == 0 ? 1 : 0;
+#endif
+  xTaskCreatePinnedToCore(senderTask, "irstream", 4096, nullptr, IRSTREAM_TASK_PRIORITY, nullptr, core);
+}
+#else
+static void startSender() {
+  // Host builds (the native benchmark) serve from a detached thread
+  std::thread([] {
+    for (;;) serve();
+  }).detach();
+}
+#endif
+
+bool begin(uint16_t port) {
+  if (listener >= 0) return true;
+  for (uint8_t i = 0; i < IRSTREAM_MAX_CLIENTS; i++) clientSlots[i].fd = -1;
+  if (!openListener(port)) return false;
+  startSender();
+  return true;
+}
+
+uint16_t port() {
+  return listenPort;
+}
+
+} // namespace irstream
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Live thermal frames over Wi-Fi: a raw TCP server that streams every
+// published frame to each connected client.
+//
+//   irstream::begin();                  // after Wi-Fi is up
+//   ...
+//   mlx.getFrame(frame);
+//   irstream::publish(frame);           // never blocks
+//
+// publish() quantizes the frame and swaps it into a triple buffer; a
+// sender task (on the other core) picks up the newest frame and does all
+// the socket work. Each client is sent either a keyframe or a delta
+// against the last frame *it* received. A client that is still receiving
+// an earlier frame simply misses the ones published meanwhile: stale
+// frames are dropped, never queued, so a slow viewer costs neither memory
+// nor time on the render loop, nor frames for the other viewers.
+//
+// Watch and measure with tools/irstream_client.py.
+//
+// Wire format, little-endian. Every message is
+//   sync 0xA5 0x5C, type(1), flags(1), payload length(2), payload
+//
+// Server to client:
+//   HELLO    version(1) width(1) height(1) reserved(1) step in milli-C(2)
+//   KEYFRAME seq(4) capture us(4) base(2) then one value per pixel:
+//            1 byte, or 2 if flags & IRSTREAM_FLAG_WIDE; temperature is
+//            (base + value) * step
+//   DELTA    seq(4) capture us(4) changed-pixel bitmap (width * height / 8,
+//            LSB first) then one 4-bit code per changed pixel (low nibble
+//            first, padded to a byte): 0-14 adds code - 7 to the pixel,
+//            15 means its new value follows in the escape list (2 bytes
+//            each, signed, in pixel order) after the codes
+//   PONG     token(4) server us(4)
+// Client to server:
+//   PING     token(4), answered with a PONG straight away (a newer PING
+//            replaces a PONG that has not started going out yet)
+//
+// "capture us" and "server us" share the server's microsecond clock, so a
+// client can estimate its offset from PING/PONG round trips and measure
+// end-to-end latency.
+
+// Host builds take any free port, so several runs can stream side by side
+// (port() says which)
+#ifndef IRSTREAM_PORT
+#if defined(ARDUINO_ARCH_ESP32)
+#define IRSTREAM_PORT 5050
+#else
+#define IRSTREAM_PORT 0
+#endif
+#endif
+#ifndef IRSTREAM_MAX_CLIENTS
+#define IRSTREAM_MAX_CLIENTS 4
+#endif
+
+// Sensor geometry
+#ifndef IRSTREAM_WIDTH
+#define IRSTREAM_WIDTH 32
+#endif
+#ifndef IRSTREAM_HEIGHT
+#define IRSTREAM_HEIGHT 24
+#endif
+
+// Quantization step (milli-degrees C)
+#ifndef IRSTREAM_STEP_MC
+#define IRSTREAM_STEP_MC 100
+#endif
+
+// Socket send buffer per client: enough for a couple of frames, so a slow
+// client's backlog stays bounded
+#ifndef IRSTREAM_SEND_BUFFER
+#define IRSTREAM_SEND_BUFFER (2 * IRSTREAM_MESSAGE_MAX)
+#endif
+
+// Sender task: longest it sleeps waiting for a frame or a socket, and its
+// FreeRTOS priority (it runs on the core the Arduino loop doesn't use)
+#ifndef IRSTREAM_POLL_MS
+#define IRSTREAM_POLL_MS 2
+#endif
+#ifndef IRSTREAM_TASK_PRIORITY
+#define IRSTREAM_TASK_PRIORITY 1
+#endif
+
+#define IRSTREAM_SYNC0   0xA5
+#define IRSTREAM_SYNC1   0x5C
+#define IRSTREAM_VERSION 1
+
+#define IRSTREAM_HELLO    0x01
+#define IRSTREAM_KEYFRAME 0x02
+#define IRSTREAM_DELTA    0x03
+#define IRSTREAM_PONG     0x04
+#define IRSTREAM_PING     0x10
+
+#define IRSTREAM_FLAG_WIDE 0x01
+
+#define IRSTREAM_PIXELS  (IRSTREAM_WIDTH * IRSTREAM_HEIGHT)
+#define IRSTREAM_HEADER  6
+// Largest message: a wide keyframe
+#define IRSTREAM_MESSAGE_MAX (IRSTREAM_HEADER + 10 + IRSTREAM_PIXELS * 2)
+
+namespace irstream {
+
+// Opens the listening socket and starts the sender task. Returns false if
+// the port could not be opened.
+bool begin(uint16_t port = IRSTREAM_PORT);
+
+// Port the server listens on (the one picked for port 0), or 0 before
+// begin().
+uint16_t port();
+
+// Hands a frame (IRSTREAM_WIDTH x IRSTREAM_HEIGHT, row major, degrees C)
+// to the sender task, replacing one it has not picked up yet. A NaN pixel
+// (a bad read) is sent as its last good value. Safe to call before begin()
+// or with nobody connected.
+void publish(const float* frame);
+
+// Clients currently connected.
+uint8_t clients();
+
+// Frames skipped for slow clients, summed over all clients.
+uint32_t dropped();
+
+// The clock "capture us" is stamped with.
+uint32_t nowMicros();
+
+} // namespace irstream
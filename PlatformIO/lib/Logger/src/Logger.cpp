@@ -0,0 +1,318 @@
+#include "Logger.h"
+#include <stdarg.h>
+
+#if !defined(ARDUINO_ARCH_ESP32)
+#include <Sim.h>
+#include <thread>
+#endif
+
+namespace logger {
+
+static_assert((LOGGER_SLOTS & (LOGGER_SLOTS - 1)) == 0, "LOGGER_SLOTS must be a power of two");
+static_assert(LOGGER_PAYLOAD <= 255, "LOGGER_PAYLOAD must fit the 8-bit lengths");
+
+// Bounded multi-producer ring: each slot's sequence number says whose turn
+// it is. A producer claims the next position with one compare-and-swap and
+// publishes the slot by bumping its sequence; the single consumer (the
+// drain task) hands it back by advancing the sequence a full lap.
+//
+// Slot i stores its sequence minus i, so the all-zero startup state is
+// already valid and logging works from static constructors, before begin().
+struct Slot {
+  std::atomic<uint32_t> seq;
+  Record record;
+};
+
+static Slot slots[LOGGER_SLOTS];
+static std::atomic<uint32_t> head(0);
+static uint32_t tail = 0;
+static std::atomic<uint32_t> drops(0);
+// Drops not yet handed to a record; the next record that makes it into the
+// ring carries the count, so the report prints in order
+static std::atomic<uint32_t> pendingDrops(0);
+
+// Set while anything writes to the output, so writeIfRoom() blocks never
+// land inside a line and its room check holds until it writes
+static std::atomic_flag outputBusy = ATOMIC_FLAG_INIT;
+static Print* output = nullptr;
+
+static inline uint32_t sequence(const Slot& slot, uint32_t index) {
+  return slot.seq.load(std::memory_order_acquire) + index;
+}
+
+static inline void setSequence(Slot& slot, uint32_t index, uint32_t seq) {
+  slot.seq.store(seq - index, std::memory_order_release);
+}
+
+void Record::put(Type type, const void* value, size_t size) {
+  if (argc == LOGGER_MAX_ARGS) return;
+  if (used + size > LOGGER_PAYLOAD) {
+    types[argc++] = SKIP; // later arguments keep their positions
+    return;
+  }
+  memcpy(payload + used, value, size);
+  used += size;
+  types[argc++] = type;
+}
+
+void Record::add(const char* s, const Reserve& later) {
+  if (argc == LOGGER_MAX_ARGS) return;
+  if (used + 1 + later.bytes > LOGGER_PAYLOAD) {
+    types[argc++] = SKIP;
+    return;
+  }
+  if (!s) s = "(null)";
+
+  // Stored as a length byte and the characters, truncated to an even share
+  // of what the later arguments leave
+  size_t room = (LOGGER_PAYLOAD - used - 1 - later.bytes) / (1 + later.strings);
+  size_t n = strnlen(s, room);
+  payload[used] = n;
+  memcpy(payload + used + 1, s, n);
+  used += n + 1;
+  types[argc++] = STR;
+}
+
+bool push(const Record& record) {
+  uint32_t pos = head.load(std::memory_order_relaxed);
+  uint32_t index;
+  for (;;) {
+    index = pos & (LOGGER_SLOTS - 1);
+    int32_t diff = (int32_t)(sequence(slots[index], index) - pos);
+    if (diff == 0) {
+      if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+    } else if (diff < 0) {
+      // The consumer hasn't freed this slot yet: full
+      drops.fetch_add(1, std::memory_order_relaxed);
+      pendingDrops.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    } else {
+      pos = head.load(std::memory_order_relaxed);
+    }
+  }
+
+  slots[index].record = record;
+  slots[index].record.droppedBefore = pendingDrops.exchange(0, std::memory_order_relaxed);
+  setSequence(slots[index], index, pos + 1);
+  return true;
+}
+
+uint32_t dropped() {
+  return drops.load(std::memory_order_relaxed);
+}
+
+void checkFormat(const char*, ...) {}
+
+// -------------------------------------------------------------------
+// FORMATTING
+// -------------------------------------------------------------------
+
+// Appends printf output at `pos`, keeping `pos` within the buffer
+static size_t append(char* buf, size_t len, size_t pos, const char* fmt, ...) __attribute__((format(printf, 4, 5)));
+static size_t append(char* buf, size_t len, size_t pos, const char* fmt, ...) {
+  if (pos + 1 >= len) return pos;
+  va_list args;
+  va_start(args, fmt);
+  int n = vsnprintf(buf + pos, len - pos, fmt, args);
+  va_end(args);
+  if (n < 0) return pos;
+  return (pos + n < len) ? pos + n : len - 1;
+}
+
+// Formats one conversion. `spec` holds the flags, width and precision from
+// the caller's format (length modifiers stripped) and room for the
+// modifier and conversion this function appends.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-nonliteral"
+static size_t convert(char* buf, size_t len, size_t pos, char* spec, size_t specLen,
+                      char conv, Record::Type type, const uint8_t* value) {
+  bool integer = strchr("diouxXc", conv) != nullptr;
+  bool real = strchr("fFeEgGaA", conv) != nullptr;
+
+  const char* modifier = "";
+  if (integer && (type == Record::I64 || type == Record::U64)) modifier = "ll";
+  snprintf(spec + specLen, 8, "%s%c", modifier, conv);
+
+  if (integer && type == Record::I32) {
+    int32_t v; memcpy(&v, value, sizeof(v));
+    return append(buf, len, pos, spec, (int)v);
+  }
+  if (integer && type == Record::U32) {
+    uint32_t v; memcpy(&v, value, sizeof(v));
+    return append(buf, len, pos, spec, (unsigned)v);
+  }
+  if (integer && type == Record::I64) {
+    long long v; memcpy(&v, value, sizeof(v));
+    return append(buf, len, pos, spec, v);
+  }
+  if (integer && type == Record::U64) {
+    unsigned long long v; memcpy(&v, value, sizeof(v));
+    return append(buf, len, pos, spec, v);
+  }
+  if (real && type == Record::F64) {
+    double v; memcpy(&v, value, sizeof(v));
+    return append(buf, len, pos, spec, v);
+  }
+  if (conv == 's' && type == Record::STR) {
+    char s[LOGGER_PAYLOAD];
+    memcpy(s, value + 1, value[0]);
+    s[value[0]] = '\0';
+    return append(buf, len, pos, spec, s);
+  }
+  if (conv == 'p' && type == Record::PTR) {
+    const void* v; memcpy(&v, value, sizeof(v));
+    return append(buf, len, pos, spec, v);
+  }
+  return append(buf, len, pos, "<?>");
+}
+#pragma GCC diagnostic pop
+
+static size_t argSize(Record::Type type, const uint8_t* value) {
+  switch (type) {
+    case Record::I32:
+    case Record::U32: return 4;
+    case Record::I64:
+    case Record::U64:
+    case Record::F64: return 8;
+    case Record::STR: return 1 + value[0];
+    case Record::PTR: return sizeof(void*);
+    case Record::SKIP: return 0;
+  }
+  return 0;
+}
+
+size_t format(const Record& r, char* buf, size_t len) {
+  static const char LEVELS[] = "?EWID";
+
+  size_t pos = append(buf, len, 0, "[%6lu.%03lu] %c ",
+                      (unsigned long)(r.timeMs / 1000), (unsigned long)(r.timeMs % 1000),
+                      LEVELS[r.level < sizeof(LEVELS) - 1 ? r.level : 0]);
+
+  const char* f = r.format;
+  uint8_t arg = 0;
+  size_t offset = 0;
+
+  while (*f && pos + 1 < len) {
+    if (*f != '%') {
+      buf[pos++] = *f++;
+      continue;
+    }
+    if (f[1] == '%') {
+      buf[pos++] = '%';
+      f += 2;
+      continue;
+    }
+
+    // Copy flags, width and precision; skip length modifiers
+    char spec[24];
+    size_t specLen = 0;
+    spec[specLen++] = *f++;
+    while (*f && strchr("-+ #0123456789.", *f) && specLen < sizeof(spec) - 8) spec[specLen++] = *f++;
+    while (*f && strchr("hljztL", *f)) f++;
+    char conv = *f;
+    if (!conv) break;
+    f++;
+
+    if (arg >= r.argc) {
+      pos = append(buf, len, pos, "<?>");
+      continue;
+    }
+    Record::Type type = (Record::Type)r.types[arg++];
+    const uint8_t* value = r.payload + offset;
+    offset += argSize(type, value);
+    pos = convert(buf, len, pos, spec, specLen, conv, type, value);
+  }
+
+  buf[pos] = '\0';
+  return pos;
+}
+
+// Blocking side of the output lock: the holder is only ever copying a block
+// into the TX buffer
+static void writeLine(Print& out, const char* line, size_t len) {
+  while (outputBusy.test_and_set(std::memory_order_acquire)) {
+#if defined(ARDUINO_ARCH_ESP32)
+    taskYIELD();
+#else
+    std::this_thread::yield();
+#endif
+  }
+  out.write((const uint8_t*)line, len);
+  outputBusy.clear(std::memory_order_release);
+}
+
+bool writeIfRoom(const uint8_t* data, size_t len) {
+  if (!output || outputBusy.test_and_set(std::memory_order_acquire)) return false;
+  bool room = output->availableForWrite() >= (int)len;
+  if (room) output->write(data, len);
+  outputBusy.clear(std::memory_order_release);
+  return room;
+}
+
+// Drop report, printed where the lost messages would have been
+static void reportDrops(Print& out, char* line, size_t len, uint32_t lost) {
+  int n = snprintf(line, len, "[log] %lu messages dropped\r\n", (unsigned long)lost);
+  writeLine(out, line, n);
+}
+
+size_t drain(Print& out, size_t max) {
+  char line[LOGGER_LINE_MAX + 2];
+  size_t n = 0;
+
+  while (n < max) {
+    uint32_t index = tail & (LOGGER_SLOTS - 1);
+    Slot& slot = slots[index];
+    if (sequence(slot, index) != tail + 1) {
+      // Caught up: drops no record has carried yet happened after all of
+      // the printed ones
+      uint32_t lost = pendingDrops.exchange(0, std::memory_order_relaxed);
+      if (lost) reportDrops(out, line, sizeof(line), lost);
+      break;
+    }
+
+    if (slot.record.droppedBefore) reportDrops(out, line, sizeof(line), slot.record.droppedBefore);
+    size_t len = format(slot.record, line, LOGGER_LINE_MAX);
+    setSequence(slot, index, tail + LOGGER_SLOTS);
+    tail++;
+
+    line[len++] = '\r';
+    line[len++] = '\n';
+    writeLine(out, line, len);
+    n++;
+  }
+  return n;
+}
+
+// -------------------------------------------------------------------
+// DRAIN TASK
+// -------------------------------------------------------------------
+
+#if defined(ARDUINO_ARCH_ESP32)
+static void drainTask(void* arg) {
+  Print& out = *static_cast<Print*>(arg);
+  for (;;) {
+    if (drain(out, LOGGER_SLOTS) == 0) vTaskDelay(pdMS_TO_TICKS(LOGGER_DRAIN_MS));
+  }
+}
+
+void begin(Print& out) {
+  output = &out;
+
+  // Keep formatting off the loop task's core so it can't steal time slices
+#if CONFIG_FREERTOS_UNICORE
+  BaseType_t core = tskNO_AFFINITY;
+#else
+  BaseType_t core = ARDUINO_RUNNING_CORE == 0 ? 1 : 0;
+#endif
+  xTaskCreatePinnedToCore(drainTask, "logger", 4096, &out, LOGGER_TASK_PRIORITY, nullptr, core);
+}
+#else
+void begin(Print& out) {
+  // The native benchmark drains between frames, where the sim counts the
+  // output the same way every run (see sim::atFrameEnd)
+  output = &out;
+  sim::atFrameEnd([] { drain(*output); });
+}
+#endif
+
+} // namespace logger
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+#include <type_traits>
+
+// Logging that never waits on the UART.
+//
+//   logger::begin(Serial);
+//   ...
+//   LOG_INFO("Raw X=%d Y=%d Z=%d", p.x, p.y, p.z);
+//
+// A LOG_* call stores the format string's address (literals live in flash)
+// and the raw argument values in a fixed-size slot of a lock-free ring;
+// a low-priority task formats and prints the slots later. If the ring is
+// full the message is counted as dropped and the caller moves on, so it is
+// safe from the render loop, other tasks and ISRs.
+//
+// Formats must be literals. Arguments may be integers, floating point,
+// pointers and C strings (copied, truncated so the arguments after them
+// still fit the slot); '*' widths are not supported.
+//
+// Messages below LOGGER_LEVEL are removed at compile time, e.g.
+//   build_flags = -D LOGGER_LEVEL=LOGGER_LEVEL_DEBUG
+
+#define LOGGER_LEVEL_NONE  0
+#define LOGGER_LEVEL_ERROR 1
+#define LOGGER_LEVEL_WARN  2
+#define LOGGER_LEVEL_INFO  3
+#define LOGGER_LEVEL_DEBUG 4
+
+#ifndef LOGGER_LEVEL
+#define LOGGER_LEVEL LOGGER_LEVEL_INFO
+#endif
+
+// Ring slots (power of two) and per-slot argument storage; a string
+// argument keeps at most LOGGER_PAYLOAD - 1 characters, fewer when other
+// arguments follow it
+#ifndef LOGGER_SLOTS
+#define LOGGER_SLOTS 64
+#endif
+#define LOGGER_MAX_ARGS 6
+#ifndef LOGGER_PAYLOAD
+#define LOGGER_PAYLOAD  40
+#endif
+
+// Longest formatted line; longer output is truncated
+#ifndef LOGGER_LINE_MAX
+#define LOGGER_LINE_MAX 160
+#endif
+
+// Drain task: how often it wakes when idle, and its FreeRTOS priority
+// (it runs on the core the Arduino loop doesn't use)
+#ifndef LOGGER_DRAIN_MS
+#define LOGGER_DRAIN_MS 20
+#endif
+#ifndef LOGGER_TASK_PRIORITY
+#define LOGGER_TASK_PRIORITY 1
+#endif
+
+namespace logger {
+
+// Payload the arguments still to be added will need: their fixed-size
+// bytes, and how many strings (one length byte each, counted in `bytes`)
+// share what is left
+struct Reserve {
+  size_t bytes;
+  uint8_t strings;
+};
+
+// One queued message. Arguments are packed back to back in `payload`,
+// each tagged with how it was stored.
+struct Record {
+  // SKIP holds the place of an argument that did not fit
+  enum Type : uint8_t { I32, U32, I64, U64, F64, STR, PTR, SKIP };
+
+  const char* format;
+  uint32_t timeMs;
+  uint32_t droppedBefore; // messages lost just before this one (set by push)
+  uint8_t level;
+  uint8_t argc;
+  uint8_t used;
+  uint8_t types[LOGGER_MAX_ARGS];
+  uint8_t payload[LOGGER_PAYLOAD];
+
+  void add(int v)                { put(I32, &v, sizeof(v)); }
+  void add(long v)               { put(sizeof(v) == 8 ? I64 : I32, &v, sizeof(v)); }
+  void add(unsigned v)           { put(U32, &v, sizeof(v)); }
+  void add(unsigned long v)      { put(sizeof(v) == 8 ? U64 : U32, &v, sizeof(v)); }
+  void add(long long v)          { put(I64, &v, sizeof(v)); }
+  void add(unsigned long long v) { put(U64, &v, sizeof(v)); }
+  void add(double v)             { put(F64, &v, sizeof(v)); }
+  void add(const void* v)        { put(PTR, &v, sizeof(v)); }
+  void add(const char* s, const Reserve& later = Reserve{ 0, 0 });
+
+private:
+  void put(Type type, const void* value, size_t size);
+};
+
+// Starts the drain task, which prints to `out` (the native sim drains after
+// every frame instead). Messages logged before begin() are kept (up to the
+// ring size) and printed once it runs.
+void begin(Print& out);
+
+// Writes `len` bytes to the begin() output between two log lines, for other
+// data sharing the port (telemetry records). Writes nothing and returns
+// false if the port's TX buffer can't take all of it, or a line is being
+// written right now; never blocks.
+bool writeIfRoom(const uint8_t* data, size_t len);
+
+// Queues a record; returns false (and counts a drop) if the ring is full
+bool push(const Record& record);
+
+// Formats and prints up to `max` queued records on the calling thread.
+// Used by the drain task, and directly on the host. Returns the count.
+size_t drain(Print& out, size_t max = SIZE_MAX);
+
+// Formats one record into `buf` (always terminated); returns its length
+size_t format(const Record& record, char* buf, size_t len);
+
+// Messages lost to a full ring since boot
+uint32_t dropped();
+
+// Never called directly: checks the arguments against the format
+// (-Wformat) without evaluating anything
+void checkFormat(const char* format, ...) __attribute__((format(printf, 1, 2)));
+
+// Payload an argument of type T takes, by the Record::add() it ends up in
+template <typename T>
+struct ArgTraits {
+  typedef typename std::decay<T>::type D;
+  static const bool string = std::is_same<D, const char*>::value || std::is_same<D, char*>::value;
+  static const size_t size = string ? 1
+                           : std::is_floating_point<D>::value ? sizeof(double)
+                           : std::is_pointer<D>::value ? sizeof(void*)
+                           : sizeof(D) < sizeof(int) ? sizeof(int) : sizeof(D);
+};
+
+// Sums ArgTraits over the first `slots` of Args
+template <typename... Args>
+struct Later {
+  static Reserve get(uint8_t) { return Reserve{ 0, 0 }; }
+};
+
+template <typename T, typename... Rest>
+struct Later<T, Rest...> {
+  static Reserve get(uint8_t slots) {
+    if (slots == 0) return Reserve{ 0, 0 };
+    Reserve r = Later<Rest...>::get(slots - 1);
+    r.bytes += ArgTraits<T>::size;
+    r.strings += ArgTraits<T>::string;
+    return r;
+  }
+};
+
+template <typename T>
+inline void addArg(Record& r, T value, const Reserve&) { r.add(value); }
+inline void addArg(Record& r, const char* s, const Reserve& later) { r.add(s, later); }
+inline void addArg(Record& r, char* s, const Reserve& later) { r.add(s, later); }
+
+inline void pack(Record&) {}
+
+template <typename T, typename... Rest>
+inline void pack(Record& r, T value, Rest... rest) {
+  uint8_t slots = r.argc < LOGGER_MAX_ARGS ? LOGGER_MAX_ARGS - r.argc - 1 : 0;
+  addArg(r, value, Later<Rest...>::get(slots));
+  pack(r, rest...);
+}
+
+template <typename... Args>
+inline void log(uint8_t level, const char* format, Args... args) {
+  Record r;
+  r.format = format;
+  r.timeMs = millis();
+  r.level = level;
+  r.argc = 0;
+  r.used = 0;
+  pack(r, args...);
+  push(r);
+}
+
+} // namespace logger
+
+#define LOGGER_WRITE(level, fmt, ...) do { \
+    if (false) logger::checkFormat(fmt, ##__VA_ARGS__); \
+    logger::log(level, fmt, ##__VA_ARGS__); \
+  } while (0)
+
+#if LOGGER_LEVEL >= LOGGER_LEVEL_ERROR
+#define LOG_ERROR(fmt, ...) LOGGER_WRITE(LOGGER_LEVEL_ERROR, fmt, ##__VA_ARGS__)
+#else
+#define LOG_ERROR(fmt, ...) do {} while (0)
+#endif
+
+#if LOGGER_LEVEL >= LOGGER_LEVEL_WARN
+#define LOG_WARN(fmt, ...) LOGGER_WRITE(LOGGER_LEVEL_WARN, fmt, ##__VA_ARGS__)
+#else
+#define LOG_WARN(fmt, ...) do {} while (0)
+#endif
+
+#if LOGGER_LEVEL >= LOGGER_LEVEL_INFO
+#define LOG_INFO(fmt, ...) LOGGER_WRITE(LOGGER_LEVEL_INFO, fmt, ##__VA_ARGS__)
+#else
+#define LOG_INFO(fmt, ...) do {} while (0)
+#endif
+
+#if LOGGER_LEVEL >= LOGGER_LEVEL_DEBUG
+#define LOG_DEBUG(fmt, ...) LOGGER_WRITE(LOGGER_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
+#else
+#define LOG_DEBUG(fmt, ...) do {} while (0)
+#endif
@@ -0,0 +1,448 @@
+#include "TFTDisplay.h"
+
+#include <Arduino.h>
+#include <driver/gpio.h>
+#include <esp_heap_caps.h>
+#include <string.h>
+
+// MADCTL bits (not exported by Adafruit_ILI9341.h)
+#define MADCTL_MY  0x80
+#define MADCTL_MX  0x40
+#define MADCTL_MV  0x20
+#define MADCTL_BGR 0x08
+
+// Solid fills are streamed from this many pixels of one color
+#define TFT_FILL_PIXELS 1280
+// Below this many pixels a fill is sent synchronously: cheaper than the
+// interrupt round trips of the queued path
+#define TFT_POLL_PIXELS 64
+
+// Init sequence from Adafruit_ILI9341: cmd, argc (bit 7 = delay 150 ms after), args...
+static const uint8_t initcmd[] = {
+  0xEF, 3, 0x03, 0x80, 0x02,
+  0xCF, 3, 0x00, 0xC1, 0x30,
+  0xED, 4, 0x64, 0x03, 0x12, 0x81,
+  0xE8, 3, 0x85, 0x00, 0x78,
+  0xCB, 5, 0x39, 0x2C, 0x00, 0x34, 0x02,
+  0xF7, 1, 0x20,
+  0xEA, 2, 0x00, 0x00,
+  ILI9341_PWCTR1  , 1, 0x23,             // Power control VRH[5:0]
+  ILI9341_PWCTR2  , 1, 0x10,             // Power control SAP[2:0];BT[3:0]
+  ILI9341_VMCTR1  , 2, 0x3e, 0x28,       // VCM control
+  ILI9341_VMCTR2  , 1, 0x86,             // VCM control2
+  ILI9341_MADCTL  , 1, 0x48,             // Memory Access Control
+  ILI9341_VSCRSADD, 1, 0x00,             // Vertical scroll zero
+  ILI9341_PIXFMT  , 1, 0x55,
+  ILI9341_FRMCTR1 , 2, 0x00, 0x18,
+  ILI9341_DFUNCTR , 3, 0x08, 0x82, 0x27, // Display Function Control
+  0xF2, 1, 0x00,                         // 3Gamma Function Disable
+  ILI9341_GAMMASET , 1, 0x01,            // Gamma curve selected
+  ILI9341_GMCTRP1 , 15, 0x0F, 0x31, 0x2B, 0x0C, 0x0E, 0x08, // Set Gamma
+    0x4E, 0xF1, 0x37, 0x07, 0x10, 0x03, 0x0E, 0x09, 0x00,
+  ILI9341_GMCTRN1 , 15, 0x00, 0x0E, 0x14, 0x03, 0x11, 0x07, // Set Gamma
+    0x31, 0xC1, 0x48, 0x08, 0x0F, 0x0C, 0x31, 0x36, 0x0F,
+  ILI9341_SLPOUT  , 0x80,                // Exit Sleep
+  ILI9341_DISPON  , 0x80,                // Display on
+  0x00                                   // End of list
+};
+
+// No address has been sent yet (or it is unknown after a rotation)
+#define TFT_NO_WINDOW 0xFFFFFFFF
+
+// The pre-transfer callback drives the D/C line named in t->user (see
+// dcLevel()), so several displays can share the bus
+static void IRAM_ATTR dcCallback(spi_transaction_t* t) {
+  intptr_t user = (intptr_t)t->user;
+  gpio_set_level((gpio_num_t)(user >> 1), (int)(user & 1));
+}
+
+TFTDisplay::TFTDisplay(int8_t cs, int8_t dc, int8_t rst, int8_t mosi, int8_t sck, int8_t miso)
+  : Adafruit_GFX(ILI9341_TFTWIDTH, ILI9341_TFTHEIGHT),
+    _cs(cs), _dc(dc), _rst(rst), _mosi(mosi), _sck(sck), _miso(miso),
+    _host(SPI2_HOST), _spi(nullptr), _busAcquired(0),
+    _transHead(0), _inFlight(0), _nextLine(0), _fillBuffer(nullptr),
+    _runBuffer(nullptr), _runX(0), _runY(0), _runLength(0), _runAxis(0),
+    _windowCols(TFT_NO_WINDOW), _windowRows(TFT_NO_WINDOW) {
+  _lineBuffers[0] = _lineBuffers[1] = nullptr;
+}
+
+bool TFTDisplay::begin(uint32_t freq) {
+  pinMode(_dc, OUTPUT);
+  digitalWrite(_dc, HIGH);
+
+  spi_bus_config_t bus;
+  memset(&bus, 0, sizeof(bus));
+  bus.mosi_io_num = _mosi;
+  bus.miso_io_num = _miso;
+  bus.sclk_io_num = _sck;
+  bus.quadwp_io_num = -1;
+  bus.quadhd_io_num = -1;
+  bus.max_transfer_sz = TFT_LINE_BUFFER_PIXELS * 2;
+  // A second display on the same bus finds it already initialized
+  esp_err_t err = spi_bus_initialize(_host, &bus, SPI_DMA_CH_AUTO);
+  if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) return false;
+
+  spi_device_interface_config_t dev;
+  memset(&dev, 0, sizeof(dev));
+  dev.clock_speed_hz = freq;
+  dev.mode = 0;
+  dev.spics_io_num = _cs;
+  dev.queue_size = TFT_QUEUE_DEPTH;
+  dev.pre_cb = dcCallback;
+  if (spi_bus_add_device(_host, &dev, &_spi) != ESP_OK) return false;
+
+  // DMA can only read internal RAM
+  for (int i = 0; i < 2; i++) {
+    _lineBuffers[i] = (uint16_t*)heap_caps_malloc(TFT_LINE_BUFFER_PIXELS * 2, MALLOC_CAP_DMA);
+    if (!_lineBuffers[i]) return false;
+  }
+  _fillBuffer = (uint16_t*)heap_caps_malloc(TFT_FILL_PIXELS * 2, MALLOC_CAP_DMA);
+  _runBuffer = (uint16_t*)heap_caps_malloc(TFT_RUN_PIXELS * 2, MALLOC_CAP_DMA);
+  if (!_fillBuffer || !_runBuffer) return false;
+
+  // Hardware reset if wired, software reset otherwise
+  if (_rst >= 0) {
+    pinMode(_rst, OUTPUT);
+    digitalWrite(_rst, HIGH);
+    delay(100);
+    digitalWrite(_rst, LOW);
+    delay(100);
+    digitalWrite(_rst, HIGH);
+    delay(200);
+  } else {
+    sendCommand(ILI9341_SWRESET);
+    delay(150);
+  }
+
+  const uint8_t* addr = initcmd;
+  uint8_t cmd;
+  while ((cmd = *addr++) > 0) {
+    uint8_t x = *addr++;
+    uint8_t numArgs = x & 0x7F;
+    sendCommand(cmd, addr, numArgs);
+    addr += numArgs;
+    if (x & 0x80) delay(150);
+  }
+
+  _width = ILI9341_TFTWIDTH;
+  _height = ILI9341_TFTHEIGHT;
+  return true;
+}
+
+// -------------------------------------------------------------------
+// Adafruit GFX overrides
+// -------------------------------------------------------------------
+
+void TFTDisplay::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  startWrite();
+  writePixel(x, y, color);
+  endWrite();
+}
+
+// Extends the current run if (x, y) comes straight after it along a row or
+// a column; otherwise sends the run and starts a new one. GFX draws glyphs
+// column by column, so opaque text goes out a whole column per window.
+void TFTDisplay::writePixel(int16_t x, int16_t y, uint16_t color) {
+  if (x < 0 || y < 0 || x >= _width || y >= _height) return;
+
+  bool extends = false;
+  if (_runLength && _runLength < TFT_RUN_PIXELS) {
+    if (_runAxis != 2 && y == _runY && x == _runX + _runLength) {
+      _runAxis = 1;
+      extends = true;
+    } else if (_runAxis != 1 && x == _runX && y == _runY + _runLength) {
+      _runAxis = 2;
+      extends = true;
+    }
+  }
+  if (!extends) {
+    flushRun();
+    _runX = x;
+    _runY = y;
+  }
+  _runBuffer[_runLength++] = swap565(color);
+
+  // Outside a startWrite()/endWrite() bracket nothing would send it later
+  if (!_busAcquired) flushRun();
+}
+
+void TFTDisplay::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  // Same normalisation and clipping as Adafruit_SPITFT::fillRect
+  if (w < 0) { x += w + 1; w = -w; }
+  if (h < 0) { y += h + 1; h = -h; }
+  if (x < 0) { w += x; x = 0; }
+  if (y < 0) { h += y; y = 0; }
+  if (x + w > _width) w = _width - x;
+  if (y + h > _height) h = _height - y;
+  if (w <= 0 || h <= 0) return;
+
+  // Pixels written before this must land first; and the fill buffer may
+  // still be streaming the previous fill
+  flushRun();
+  waitIdle();
+
+  uint32_t n = (uint32_t)w * h;
+  uint32_t chunk = n < TFT_FILL_PIXELS ? n : TFT_FILL_PIXELS;
+  uint16_t c = swap565(color);
+  for (uint32_t i = 0; i < chunk; i++) _fillBuffer[i] = c;
+
+  if (n <= TFT_POLL_PIXELS) {
+    sendWindow(x, y, w, h);
+    sendPixels(_fillBuffer, n * 2);
+    return;
+  }
+
+  // Queue the same buffer until the rect is covered; the last chunk is
+  // still going out when we return
+  queueWindow(x, y, w, h);
+  while (n) {
+    uint32_t len = n < chunk ? n : chunk;
+    queue(_fillBuffer, len * 2, true);
+    n -= len;
+  }
+}
+
+void TFTDisplay::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+  fillRect(x, y, w, 1, color);
+}
+
+void TFTDisplay::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+  fillRect(x, y, 1, h, color);
+}
+
+void TFTDisplay::fillScreen(uint16_t color) {
+  fillRect(0, 0, _width, _height, color);
+}
+
+void TFTDisplay::setRotation(uint8_t m) {
+  flushRun();
+  rotation = m % 4;
+  switch (rotation) {
+    case 0:
+      m = (MADCTL_MX | MADCTL_BGR);
+      _width = ILI9341_TFTWIDTH;
+      _height = ILI9341_TFTHEIGHT;
+      break;
+    case 1:
+      m = (MADCTL_MV | MADCTL_BGR);
+      _width = ILI9341_TFTHEIGHT;
+      _height = ILI9341_TFTWIDTH;
+      break;
+    case 2:
+      m = (MADCTL_MY | MADCTL_BGR);
+      _width = ILI9341_TFTWIDTH;
+      _height = ILI9341_TFTHEIGHT;
+      break;
+    case 3:
+      m = (MADCTL_MX | MADCTL_MY | MADCTL_MV | MADCTL_BGR);
+      _width = ILI9341_TFTHEIGHT;
+      _height = ILI9341_TFTWIDTH;
+      break;
+  }
+  sendCommand(ILI9341_MADCTL, &m, 1);
+  _windowCols = _windowRows = TFT_NO_WINDOW;
+}
+
+void TFTDisplay::invertDisplay(bool i) {
+  flushRun();
+  sendCommand(i ? ILI9341_INVON : ILI9341_INVOFF);
+}
+
+// GFX brackets each primitive (a glyph, a circle...) with these. Holding the
+// bus for the duration makes the polling transfers much cheaper, and the
+// pixel run collected meanwhile is sent at the end.
+void TFTDisplay::startWrite() {
+  if (_busAcquired++ == 0) {
+    waitIdle();
+    spi_device_acquire_bus(_spi, portMAX_DELAY);
+  }
+}
+
+void TFTDisplay::endWrite() {
+  if (_busAcquired && --_busAcquired == 0) {
+    flushRun();
+    waitIdle();
+    spi_device_release_bus(_spi);
+  }
+}
+
+void TFTDisplay::drawRGBBitmap(int16_t x, int16_t y, const uint16_t* bitmap, int16_t w, int16_t h) {
+  // Clip to the screen, keeping the source stride
+  int16_t stride = w;
+  if (x < 0) { bitmap -= x; w += x; x = 0; }
+  if (y < 0) { bitmap -= y * stride; h += y; y = 0; }
+  if (x + w > _width) w = _width - x;
+  if (y + h > _height) h = _height - y;
+  if (w <= 0 || h <= 0) return;
+  flushRun();
+
+  // Swap into the line buffers a band at a time; each band is sent while
+  // the next one is being converted
+  int16_t rows = TFT_LINE_BUFFER_PIXELS / w;
+  for (int16_t row = 0; row < h; row += rows) {
+    int16_t n = h - row < rows ? h - row : rows;
+    uint16_t* band = lineBuffer();
+    uint16_t* dst = band;
+    for (int16_t j = 0; j < n; j++) {
+      const uint16_t* src = bitmap + (row + j) * stride;
+      for (int16_t i = 0; i < w; i++) *dst++ = swap565(src[i]);
+    }
+    pushRect(x, y + row, w, n, band);
+  }
+  waitIdle();
+}
+
+// -------------------------------------------------------------------
+// Asynchronous DMA path
+// -------------------------------------------------------------------
+
+uint16_t* TFTDisplay::lineBuffer() {
+  // pushRect() only returns once the push before it is done, so the buffer
+  // handed out here (last used two pushes ago) is never still in flight
+  uint16_t* buffer = _lineBuffers[_nextLine];
+  _nextLine ^= 1;
+  return buffer;
+}
+
+void TFTDisplay::pushRect(int16_t x, int16_t y, int16_t w, int16_t h, const uint16_t* pixels) {
+  if (w <= 0 || h <= 0) return;
+  flushRun();
+
+  queueWindow(x, y, w, h);
+  uint8_t queued = 5;
+
+  const uint8_t* p = (const uint8_t*)pixels;
+  size_t len = (size_t)w * h * 2;
+  while (len) {
+    size_t chunk = len < TFT_LINE_BUFFER_PIXELS * 2 ? len : TFT_LINE_BUFFER_PIXELS * 2;
+    queue(p, chunk, true);
+    p += chunk;
+    len -= chunk;
+    queued++;
+  }
+
+  // Transactions complete in order: once only ours are left, the previous
+  // push (and its buffer) is done
+  while (_inFlight > queued) reapOne();
+}
+
+void TFTDisplay::waitIdle() {
+  while (_inFlight) reapOne();
+}
+
+spi_device_handle_t TFTDisplay::addDevice(int8_t cs, uint32_t freq, uint8_t mode) {
+  spi_device_interface_config_t dev;
+  memset(&dev, 0, sizeof(dev));
+  dev.clock_speed_hz = freq;
+  dev.mode = mode;
+  dev.spics_io_num = cs;
+  dev.queue_size = 1;
+
+  spi_device_handle_t handle = nullptr;
+  if (spi_bus_add_device(_host, &dev, &handle) != ESP_OK) return nullptr;
+  return handle;
+}
+
+// -------------------------------------------------------------------
+// Transfers
+// -------------------------------------------------------------------
+
+void TFTDisplay::queue(const void* data, size_t len, bool isData) {
+  if (_inFlight == TFT_QUEUE_DEPTH) reapOne();
+
+  spi_transaction_t* t = &_trans[_transHead];
+  _transHead = (_transHead + 1) % TFT_QUEUE_DEPTH;
+
+  memset(t, 0, sizeof(*t));
+  t->length = len * 8;
+  t->user = dcLevel(isData);
+  if (len <= 4) {
+    // Short commands/arguments travel inside the transaction itself
+    t->flags = SPI_TRANS_USE_TXDATA;
+    memcpy(t->tx_data, data, len);
+  } else {
+    t->tx_buffer = data;
+  }
+
+  spi_device_queue_trans(_spi, t, portMAX_DELAY);
+  _inFlight++;
+}
+
+void TFTDisplay::queueWindow(int16_t x, int16_t y, int16_t w, int16_t h) {
+  uint16_t x2 = x + w - 1, y2 = y + h - 1;
+  uint8_t caset = ILI9341_CASET, paset = ILI9341_PASET, ramwr = ILI9341_RAMWR;
+  uint8_t cols[4] = { (uint8_t)(x >> 8), (uint8_t)x, (uint8_t)(x2 >> 8), (uint8_t)x2 };
+  uint8_t rows[4] = { (uint8_t)(y >> 8), (uint8_t)y, (uint8_t)(y2 >> 8), (uint8_t)y2 };
+
+  queue(&caset, 1, false);
+  queue(cols, 4, true);
+  queue(&paset, 1, false);
+  queue(rows, 4, true);
+  queue(&ramwr, 1, false);
+  _windowCols = ((uint32_t)x << 16) | x2;
+  _windowRows = ((uint32_t)y << 16) | y2;
+}
+
+void TFTDisplay::reapOne() {
+  spi_transaction_t* done;
+  spi_device_get_trans_result(_spi, &done, portMAX_DELAY);
+  _inFlight--;
+}
+
+void TFTDisplay::sendCommand(uint8_t cmd, const uint8_t* data, uint8_t len) {
+  // Polling transfers may not overtake queued ones on the same device
+  waitIdle();
+
+  spi_transaction_t t;
+  memset(&t, 0, sizeof(t));
+  t.length = 8;
+  t.flags = SPI_TRANS_USE_TXDATA;
+  t.tx_data[0] = cmd;
+  t.user = dcLevel(false);
+  spi_device_polling_transmit(_spi, &t);
+
+  if (len) sendPixels(data, len);
+}
+
+// Only resends the column or page address if it changed: the panel keeps
+// both across RAMWR
+void TFTDisplay::sendWindow(int16_t x, int16_t y, int16_t w, int16_t h) {
+  uint16_t x2 = x + w - 1, y2 = y + h - 1;
+  uint32_t cols = ((uint32_t)x << 16) | x2;
+  uint32_t rows = ((uint32_t)y << 16) | y2;
+
+  if (cols != _windowCols) {
+    uint8_t args[4] = { (uint8_t)(x >> 8), (uint8_t)x, (uint8_t)(x2 >> 8), (uint8_t)x2 };
+    sendCommand(ILI9341_CASET, args, 4);
+    _windowCols = cols;
+  }
+  if (rows != _windowRows) {
+    uint8_t args[4] = { (uint8_t)(y >> 8), (uint8_t)y, (uint8_t)(y2 >> 8), (uint8_t)y2 };
+    sendCommand(ILI9341_PASET, args, 4);
+    _windowRows = rows;
+  }
+  sendCommand(ILI9341_RAMWR);
+}
+
+void TFTDisplay::sendPixels(const void* data, size_t len) {
+  spi_transaction_t t;
+  memset(&t, 0, sizeof(t));
+  t.length = len * 8;
+  t.user = dcLevel(true);
+  if (len <= 4) {
+    t.flags = SPI_TRANS_USE_TXDATA;
+    memcpy(t.tx_data, data, len);
+  } else {
+    t.tx_buffer = data;
+  }
+  spi_device_polling_transmit(_spi, &t);
+}
+
+void TFTDisplay::flushRun() {
+  if (!_runLength) return;
+  uint16_t n = _runLength;
+  _runLength = 0;
+  sendWindow(_runX, _runY, _runAxis == 2 ? 1 : n, _runAxis == 2 ? n : 1);
+  sendPixels(_runBuffer, n * 2);
+  _runAxis = 0;
+}
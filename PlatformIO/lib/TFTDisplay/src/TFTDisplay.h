@@ -0,0 +1,120 @@
+#pragma once
+
+#include <Adafruit_GFX.h>
+#include <Adafruit_ILI9341.h> // ILI9341_* colors and command names
+#include <driver/spi_master.h>
+#include "TFTPins.h"
+
+// Transactions the driver keeps queued on the SPI peripheral
+#ifndef TFT_QUEUE_DEPTH
+#define TFT_QUEUE_DEPTH 16
+#endif
+
+// Longest run of single pixels (a glyph column, a line segment...) that is
+// collected before it goes out as one window
+#ifndef TFT_RUN_PIXELS
+#define TFT_RUN_PIXELS 64
+#endif
+
+// ILI9341 on the ESP-IDF spi_master driver.
+//
+// Drop-in for Adafruit_ILI9341: it is an Adafruit_GFX, so text, fonts,
+// lines, circles etc. work unchanged. On top of that it exposes the DMA
+// path directly:
+//
+//   uint16_t* strip = tft.lineBuffer();   // free buffer (the other may be in flight)
+//   ...fill strip with tft.swap565(color) pixels...
+//   tft.pushStrip(y, rows, strip);        // queued, returns while DMA runs
+//
+// pushRect()/pushStrip() return as soon as the transfer is queued, once the
+// *previous* push has completed. Alternating the two line buffers therefore
+// lets the CPU build strip N+1 while strip N is on the wire.
+//
+// Single pixels (GFX text, lines, circles) are collected between
+// startWrite() and endWrite(): consecutive pixels along a row or column go
+// out as one window, and the column/page address is only resent when it
+// changes.
+class TFTDisplay : public Adafruit_GFX {
+public:
+  TFTDisplay(int8_t cs = TFT_CS, int8_t dc = TFT_DC, int8_t rst = TFT_RST,
+             int8_t mosi = TFT_MOSI, int8_t sck = TFT_SCK, int8_t miso = TFT_MISO);
+
+  // Brings up the SPI bus (DMA) and runs the panel init sequence.
+  // Returns false if the bus or line buffers could not be allocated.
+  bool begin(uint32_t freq = TFT_SPI_HZ);
+
+  // --- Adafruit GFX overrides ---
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+  void writePixel(int16_t x, int16_t y, uint16_t color) override;
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+  void fillScreen(uint16_t color) override;
+  void setRotation(uint8_t r) override;
+  void invertDisplay(bool i) override;
+  void startWrite() override;
+  void endWrite() override;
+
+  // Blocking, native-endian bitmap (same as Adafruit_SPITFT::drawRGBBitmap).
+  // The masked and PROGMEM overloads stay GFX's.
+  using Adafruit_GFX::drawRGBBitmap;
+  void drawRGBBitmap(int16_t x, int16_t y, const uint16_t* bitmap, int16_t w, int16_t h);
+  void drawRGBBitmap(int16_t x, int16_t y, uint16_t* bitmap, int16_t w, int16_t h) {
+    drawRGBBitmap(x, y, (const uint16_t*)bitmap, w, h);
+  }
+
+  uint16_t color565(uint8_t r, uint8_t g, uint8_t b) const {
+    return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+  }
+
+  // The panel takes RGB565 most significant byte first
+  static uint16_t swap565(uint16_t color) { return (color << 8) | (color >> 8); }
+
+  // --- Asynchronous DMA path (pixels already byte-swapped) ---
+  uint16_t* lineBuffer();
+  size_t lineBufferPixels() const { return TFT_LINE_BUFFER_PIXELS; }
+  void pushRect(int16_t x, int16_t y, int16_t w, int16_t h, const uint16_t* pixels);
+  void pushStrip(int16_t y, int16_t h, const uint16_t* pixels) { pushRect(0, y, _width, h, pixels); }
+
+  // Blocks until every queued transfer has reached the panel.
+  void waitIdle();
+
+  // Adds another device (e.g. the touch controller) on the same bus so the
+  // driver arbitrates between them. Call after begin().
+  spi_device_handle_t addDevice(int8_t cs, uint32_t freq, uint8_t mode = 0);
+
+private:
+  void queue(const void* data, size_t len, bool isData);
+  void queueWindow(int16_t x, int16_t y, int16_t w, int16_t h);
+  void reapOne();
+  void sendCommand(uint8_t cmd, const uint8_t* data = nullptr, uint8_t len = 0);
+  void sendWindow(int16_t x, int16_t y, int16_t w, int16_t h);
+  void sendPixels(const void* data, size_t len);
+  void flushRun();
+
+  // pre_cb argument: D/C pin and level, so each display drives its own
+  void* dcLevel(bool isData) const { return (void*)(intptr_t)((_dc << 1) | (isData ? 1 : 0)); }
+
+  int8_t _cs, _dc, _rst, _mosi, _sck, _miso;
+  spi_host_device_t _host;
+  spi_device_handle_t _spi;
+  uint8_t _busAcquired; // startWrite() nesting depth
+
+  spi_transaction_t _trans[TFT_QUEUE_DEPTH];
+  uint8_t _transHead;
+  uint8_t _inFlight;
+
+  uint16_t* _lineBuffers[2];
+  uint8_t _nextLine;
+  uint16_t* _fillBuffer;
+
+  // Pixels collected by writePixel(): _runLength of them from (_runX, _runY)
+  // along _runAxis (0 = undecided, 1 = row, 2 = column)
+  uint16_t* _runBuffer;
+  int16_t _runX, _runY;
+  uint16_t _runLength;
+  uint8_t _runAxis;
+
+  // Column and page address last sent (start << 16 | end)
+  uint32_t _windowCols, _windowRows;
+};
@@ -0,0 +1,33 @@
+#pragma once
+
+// --- PIN DEFINITIONS ---
+// The wiring every project uses (left header of the ESP32-S3 dev board).
+// Override any of these with build_flags, e.g. -D TFT_CS=5
+#ifndef TFT_CS
+#define TFT_CS    10
+#endif
+#ifndef TFT_DC
+#define TFT_DC    8
+#endif
+#ifndef TFT_RST
+#define TFT_RST   4
+#endif
+#ifndef TFT_MOSI
+#define TFT_MOSI  11 // Shared Data
+#endif
+#ifndef TFT_SCK
+#define TFT_SCK   12 // Shared Clock
+#endif
+#ifndef TFT_MISO
+#define TFT_MISO  -1 // Only the touch controller reads back (GPIO 9)
+#endif
+
+// SPI clock for the panel
+#ifndef TFT_SPI_HZ
+#define TFT_SPI_HZ 40000000
+#endif
+
+// Pixels per DMA line buffer (two are allocated): 320 x 20 lines = 12.5 KB each
+#ifndef TFT_LINE_BUFFER_PIXELS
+#define TFT_LINE_BUFFER_PIXELS (320 * 20)
+#endif
@@ -0,0 +1,125 @@
+#include "TFTTouch.h"
+
+#include <string.h>
+
+// Thresholds and sampling from XPT2046_Touchscreen
+#define Z_THRESHOLD     400
+#define Z_THRESHOLD_INT 75
+#define MSEC_THRESHOLD  3
+#define TOUCH_SPI_HZ    2000000
+
+// One full-duplex burst replaces the library's sequence of transfer16() calls:
+// Z1, Z2, a throw-away X, then three Y/X pairs (the first X is always noisy).
+// Each conversion result comes back in the two bytes after its command, so
+// the next command goes out with the second of them (transfer16() sends the
+// high byte first). The burst is padded to whole words and both buffers are
+// word-aligned in internal RAM, so the driver DMAs them in place instead of
+// copying through bounce buffers on every poll.
+static DMA_ATTR const uint8_t sampleCmds[] = {
+  0xB1,          // Z1
+  0x00, 0xC1,    // Z2            -> Z1
+  0x00, 0x91,    // X (dummy)     -> Z2
+  0x00, 0x91,    // X             -> dummy
+  0x00, 0xD1,    // Y             -> X0
+  0x00, 0x91,    // X             -> Y0
+  0x00, 0xD1,    // Y             -> X1
+  0x00, 0x91,    // X             -> Y1
+  0x00, 0xD0,    // Y, power down -> X2
+  0x00, 0x00,    //               -> Y2
+  0x00           // padding
+};
+static_assert(sizeof(sampleCmds) % 4 == 0, "DMA transfers must be whole words");
+
+static int16_t result(const uint8_t* rx, int i) {
+  return ((rx[i] << 8) | rx[i + 1]) >> 3;
+}
+
+// Average of the two closest of three samples
+static int16_t besttwoavg(int16_t x, int16_t y, int16_t z) {
+  int16_t da = (x > y) ? x - y : y - x;
+  int16_t db = (x > z) ? x - z : z - x;
+  int16_t dc = (z > y) ? z - y : y - z;
+
+  if (da <= db && da <= dc) return (x + y) >> 1;
+  if (db <= da && db <= dc) return (x + z) >> 1;
+  return (y + z) >> 1;
+}
+
+TFTTouch::TFTTouch(TFTDisplay& display, int8_t cs, int8_t irq)
+  : _display(display), _cs(cs), _irq(irq), _spi(nullptr), _rotation(1),
+    _xraw(0), _yraw(0), _zraw(0), _lastUpdate(0), _irqFlag(true) {}
+
+bool TFTTouch::begin() {
+  _spi = _display.addDevice(_cs, TOUCH_SPI_HZ, 0);
+  if (!_spi) return false;
+
+  if (_irq >= 0) {
+    pinMode(_irq, INPUT);
+    attachInterruptArg(digitalPinToInterrupt(_irq), isr, this, FALLING);
+  }
+  return true;
+}
+
+void IRAM_ATTR TFTTouch::isr(void* arg) {
+  static_cast<TFTTouch*>(arg)->_irqFlag = true;
+}
+
+bool TFTTouch::touched() {
+  update();
+  return _zraw >= Z_THRESHOLD;
+}
+
+TouchPoint TFTTouch::getPoint() {
+  update();
+  TouchPoint p = { _xraw, _yraw, _zraw };
+  return p;
+}
+
+void TFTTouch::update() {
+  if (_irq >= 0 && !_irqFlag) return;
+
+  uint32_t now = millis();
+  if (now - _lastUpdate < MSEC_THRESHOLD) return;
+
+  WORD_ALIGNED_ATTR uint8_t rx[sizeof(sampleCmds)];
+  spi_transaction_t t;
+  memset(&t, 0, sizeof(t));
+  t.length = sizeof(sampleCmds) * 8;
+  t.tx_buffer = sampleCmds;
+  t.rx_buffer = rx;
+  spi_device_polling_transmit(_spi, &t);
+  _lastUpdate = now;
+
+  int16_t z1 = result(rx, 1);
+  int16_t z2 = result(rx, 3);
+  int z = z1 + 4095 - z2;
+  if (z < 0) z = 0;
+
+  if (z < Z_THRESHOLD) {
+    _zraw = 0;
+    if (z < Z_THRESHOLD_INT && _irq >= 0) _irqFlag = false;
+    return;
+  }
+  _zraw = z;
+
+  int16_t x = besttwoavg(result(rx, 7), result(rx, 11), result(rx, 15));
+  int16_t y = besttwoavg(result(rx, 9), result(rx, 13), result(rx, 17));
+
+  switch (_rotation) {
+    case 0:
+      _xraw = 4095 - y;
+      _yraw = x;
+      break;
+    case 1:
+      _xraw = x;
+      _yraw = y;
+      break;
+    case 2:
+      _xraw = y;
+      _yraw = 4095 - x;
+      break;
+    default:
+      _xraw = 4095 - x;
+      _yraw = 4095 - y;
+  }
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <Arduino.h>
+#include "TFTDisplay.h"
+
+struct TouchPoint {
+  int16_t x;
+  int16_t y;
+  int16_t z;
+};
+
+// XPT2046 resistive touch controller on the display's SPI bus.
+//
+// Same interface and filtering as XPT2046_Touchscreen, but it talks through
+// spi_master as a second device so it can share SCK/MOSI/MISO with a
+// TFTDisplay that is streaming DMA transfers.
+class TFTTouch {
+public:
+  TFTTouch(TFTDisplay& display, int8_t cs, int8_t irq = -1);
+
+  // Call after display.begin().
+  bool begin();
+
+  bool touched();
+  bool tirqTouched() const { return _irqFlag; }
+  TouchPoint getPoint();
+  void setRotation(uint8_t r) { _rotation = r % 4; }
+
+private:
+  void update();
+
+  TFTDisplay& _display;
+  int8_t _cs;
+  int8_t _irq;
+  spi_device_handle_t _spi;
+  uint8_t _rotation;
+  int16_t _xraw, _yraw, _zraw;
+  uint32_t _lastUpdate;
+  volatile bool _irqFlag;
+
+  static void IRAM_ATTR isr(void* arg);
+};
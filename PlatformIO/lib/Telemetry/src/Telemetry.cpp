@@ -0,0 +1,186 @@
+#include "Telemetry.h"
+
+namespace telemetry {
+
+struct Stage {
+  const char* name;
+  uint32_t count;
+  uint64_t sum;
+  uint32_t min;
+  uint32_t max;
+  uint16_t buckets[TELEMETRY_BUCKETS]; // saturating; a window never gets near 65535 samples
+};
+
+static Stage stages[TELEMETRY_MAX_STAGES];
+static uint8_t stageCount = 0;
+static uint32_t windowStart = 0;
+
+// Worst case: every stage has a full-length name and every bucket in use
+#define TELEMETRY_RECORD_MAX (8 + TELEMETRY_MAX_STAGES * (1 + 15 + 5 + 10 + 5 + 5 + 1 + TELEMETRY_BUCKETS * 4))
+
+// Values below 4 get their own bucket; above that, 4 buckets per power of
+// two indexed by the exponent and the two bits under the leading one.
+static inline uint8_t bucketOf(uint32_t v) {
+  if (v < 4) return v;
+  uint8_t e = 31 - __builtin_clz(v);
+  return ((e - 1) << 2) | ((v >> (e - 2)) & 3);
+}
+
+uint8_t addStage(const char* name) {
+  for (uint8_t i = 0; i < stageCount; i++) {
+    if (stages[i].name == name || strcmp(stages[i].name, name) == 0) return i;
+  }
+  if (stageCount == TELEMETRY_MAX_STAGES) return 0xFF;
+
+  Stage& s = stages[stageCount];
+  memset(&s, 0, sizeof(s));
+  s.name = name;
+  s.min = UINT32_MAX;
+  if (stageCount == 0) windowStart = millis();
+  return stageCount++;
+}
+
+void record(uint8_t stage, uint32_t elapsed) {
+  if (stage >= stageCount) return;
+  Stage& s = stages[stage];
+  s.count++;
+  s.sum += elapsed;
+  if (elapsed < s.min) s.min = elapsed;
+  if (elapsed > s.max) s.max = elapsed;
+  uint16_t& b = s.buckets[bucketOf(elapsed)];
+  if (b != UINT16_MAX) b++;
+}
+
+void reset() {
+  for (uint8_t i = 0; i < stageCount; i++) {
+    Stage& s = stages[i];
+    s.count = 0;
+    s.sum = 0;
+    s.min = UINT32_MAX;
+    s.max = 0;
+    memset(s.buckets, 0, sizeof(s.buckets));
+  }
+  windowStart = millis();
+}
+
+// -------------------------------------------------------------------
+// ENCODING
+// -------------------------------------------------------------------
+// Record layout (little-endian, integers marked * are LEB128 varints):
+//   A5 5A  version  stageCount  payloadLength(u16)
+//   payload:
+//     timestamp ms (u32)  window ms (u32)  cpu MHz (u16)
+//     per stage: nameLength(u8) name  count*  sumCycles*  minCycles*  maxCycles*
+//                usedBuckets(u8) { bucket(u8) samples* } ...
+//   CRC-16/CCITT-FALSE of the payload (u16)
+
+class Writer {
+public:
+  Writer(uint8_t* buf, size_t len) : _buf(buf), _len(len), _pos(0) {}
+
+  void u8(uint8_t v) {
+    if (_pos < _len) _buf[_pos] = v;
+    _pos++;
+  }
+  void u16(uint16_t v) { u8(v); u8(v >> 8); }
+  void u32(uint32_t v) { u16(v); u16(v >> 16); }
+  void varint(uint64_t v) {
+    while (v >= 0x80) {
+      u8((uint8_t)v | 0x80);
+      v >>= 7;
+    }
+    u8((uint8_t)v);
+  }
+  void bytes(const char* p, size_t n) { while (n--) u8(*p++); }
+
+  size_t pos() const { return _pos; }
+  bool overflowed() const { return _pos > _len; }
+
+private:
+  uint8_t* _buf;
+  size_t _len;
+  size_t _pos;
+};
+
+static uint16_t crc16(const uint8_t* p, size_t n) {
+  uint16_t crc = 0xFFFF;
+  while (n--) {
+    crc ^= (uint16_t)(*p++) << 8;
+    for (uint8_t i = 0; i < 8; i++) crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+  }
+  return crc;
+}
+
+size_t encode(uint8_t* buf, size_t len) {
+  Writer w(buf, len);
+  w.u8(TELEMETRY_SYNC0);
+  w.u8(TELEMETRY_SYNC1);
+  w.u8(TELEMETRY_VERSION);
+  w.u8(stageCount);
+  w.u16(0); // payload length, patched below
+
+  uint32_t now = millis();
+  w.u32(now);
+  w.u32(now - windowStart);
+  w.u16(getCpuFrequencyMhz());
+
+  for (uint8_t i = 0; i < stageCount; i++) {
+    const Stage& s = stages[i];
+    size_t nameLen = strlen(s.name);
+    if (nameLen > 15) nameLen = 15;
+    w.u8(nameLen);
+    w.bytes(s.name, nameLen);
+
+    w.varint(s.count);
+    w.varint(s.sum);
+    w.varint(s.count ? s.min : 0);
+    w.varint(s.max);
+
+    uint8_t used = 0;
+    for (uint8_t b = 0; b < TELEMETRY_BUCKETS; b++) used += s.buckets[b] != 0;
+    w.u8(used);
+    for (uint8_t b = 0; b < TELEMETRY_BUCKETS; b++) {
+      if (!s.buckets[b]) continue;
+      w.u8(b);
+      w.varint(s.buckets[b]);
+    }
+  }
+
+  size_t payload = w.pos() - 6;
+  w.u16(0); // CRC placeholder
+  if (w.overflowed()) return 0;
+
+  buf[4] = payload;
+  buf[5] = payload >> 8;
+  uint16_t crc = crc16(buf + 6, payload);
+  buf[6 + payload] = crc;
+  buf[7 + payload] = crc >> 8;
+  return w.pos();
+}
+
+static uint8_t exportRecord[TELEMETRY_RECORD_MAX];
+
+// Encodes the window into exportRecord once it is complete; 0 until then
+static size_t encodeIfDue() {
+  if (stageCount == 0 || millis() - windowStart < TELEMETRY_EXPORT_MS) return 0;
+  return encode(exportRecord, sizeof(exportRecord));
+}
+
+bool exportIfDue(Print& out) {
+  size_t n = encodeIfDue();
+  if (n == 0 || out.availableForWrite() < (int)n) return false;
+
+  out.write(exportRecord, n);
+  reset();
+  return true;
+}
+
+bool exportIfDue(bool (*write)(const uint8_t* data, size_t len)) {
+  size_t n = encodeIfDue();
+  if (n == 0 || !write(exportRecord, n)) return false;
+
+  reset();
+  return true;
+}
+
+} // namespace telemetry
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Per-stage latency histograms driven by the CPU cycle counter.
+//
+//   static const uint8_t STAGE_CAPTURE = telemetry::addStage("capture");
+//   ...
+//   { TELEMETRY_SCOPE(STAGE_CAPTURE); mlx.getFrame(frame); }
+//   ...
+//   telemetry::exportIfDue(Serial);
+//
+// When the port is shared with lib/Logger, export through its writer
+// instead so records and log lines can't interleave:
+//
+//   telemetry::exportIfDue(logger::writeIfRoom);
+//
+// A scope costs two cycle-counter reads and a handful of integer ops, so it
+// is meant to stay in production builds. Build with -D TELEMETRY_DISABLE to
+// compile every scope away.
+//
+// Stages are recorded without locking: time them from a single task.
+
+#ifndef TELEMETRY_MAX_STAGES
+#define TELEMETRY_MAX_STAGES 8
+#endif
+#ifndef TELEMETRY_EXPORT_MS
+#define TELEMETRY_EXPORT_MS 2000
+#endif
+
+// Log-linear histogram: 4 buckets per power of two (<= 12.5% error),
+// covering the whole 32-bit cycle range
+#define TELEMETRY_BUCKETS 124
+
+// Binary record framing (see tools/telemetry_decode.py)
+#define TELEMETRY_SYNC0   0xA5
+#define TELEMETRY_SYNC1   0x5A
+#define TELEMETRY_VERSION 1
+
+namespace telemetry {
+
+// CPU cycle counter (the native sim derives it from its clock at 240 MHz)
+inline uint32_t cycles() {
+  return ESP.getCycleCount();
+}
+
+// Registers a named stage and returns its id (0xFF once the table is full).
+// `name` must stay valid (a literal); at most 15 characters are exported.
+uint8_t addStage(const char* name);
+
+void record(uint8_t stage, uint32_t elapsed);
+
+// Serializes every stage into one framed record. Returns the record size,
+// or 0 if it does not fit in `len`.
+size_t encode(uint8_t* buf, size_t len);
+
+// Drops all samples (the export window restarts).
+void reset();
+
+// Every TELEMETRY_EXPORT_MS, writes a record to `out` and starts a new
+// window. Skips (and keeps accumulating) if the port's TX buffer can't take
+// the whole record, so it never blocks the caller. Only safe if nothing
+// else writes to `out` from another task.
+bool exportIfDue(Print& out);
+
+// Same, through `write`, which must either take the whole record and return
+// true or write nothing and return false without blocking.
+bool exportIfDue(bool (*write)(const uint8_t* data, size_t len));
+
+class Scope {
+public:
+  explicit Scope(uint8_t stage) : _stage(stage), _start(cycles()) {}
+  ~Scope() { record(_stage, cycles() - _start); }
+
+private:
+  uint8_t _stage;
+  uint32_t _start;
+};
+
+} // namespace telemetry
+
+#define TELEMETRY_CONCAT_(a, b) a##b
+#define TELEMETRY_CONCAT(a, b) TELEMETRY_CONCAT_(a, b)
+
+#ifdef TELEMETRY_DISABLE
+#define TELEMETRY_SCOPE(stage) do {} while (0)
+#else
+#define TELEMETRY_SCOPE(stage) telemetry::Scope TELEMETRY_CONCAT(_telemetryScope, __LINE__)(stage)
+#endif
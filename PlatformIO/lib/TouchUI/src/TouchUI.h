@@ -0,0 +1,22 @@
+#pragma once
+
+// Retained-mode UI for the 320x240 ILI9341 projects.
+//
+//   ui::SPITFTTarget target(tft);
+//   ui::Compositor compositor(target);
+//   ui::Screen home;
+//   ui::Label title(ui::Rect(10, 10, 300, 20), "Hello");
+//   home.add(title);
+//   compositor.show(home);
+//
+//   loop: compositor.touch(pressed, x, y); title.setText(...); compositor.update();
+//
+// Widgets only invalidate what changed; update() repaints just those areas.
+
+#include "UIRect.h"
+#include "UICanvas.h"
+#include "UIWidgets.h"
+#include "UIHitGrid.h"
+#include "UIScreen.h"
+#include "UIFlushTarget.h"
+#include "UICompositor.h"
@@ -0,0 +1,50 @@
+#include "UICanvas.h"
+
+namespace ui {
+
+StripCanvas::StripCanvas()
+  : Adafruit_GFX(UI_SCREEN_WIDTH, UI_SCREEN_HEIGHT), _buffer(nullptr), _swap(false) {}
+
+static inline uint16_t swapped(uint16_t color, bool swap) {
+  return swap ? (uint16_t)((color << 8) | (color >> 8)) : color;
+}
+
+void StripCanvas::begin(const Rect& region, uint16_t* buffer) {
+  _region = region;
+  _clip = region;
+  _buffer = buffer;
+}
+
+void StripCanvas::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  // Unsigned compare rejects negative offsets as well
+  if ((uint16_t)(x - _clip.x) >= (uint16_t)_clip.w || (uint16_t)(y - _clip.y) >= (uint16_t)_clip.h) return;
+  _buffer[(y - _region.y) * _region.w + (x - _region.x)] = swapped(color, _swap);
+}
+
+void StripCanvas::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  Rect r = _clip.intersect(Rect(x, y, w, h));
+  if (r.empty()) return;
+
+  color = swapped(color, _swap);
+  uint16_t* row = _buffer + (r.y - _region.y) * _region.w + (r.x - _region.x);
+  for (int16_t j = 0; j < r.h; j++) {
+    for (int16_t i = 0; i < r.w; i++) row[i] = color;
+    row += _region.w;
+  }
+}
+
+void StripCanvas::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+  fillRect(x, y, w, 1, color);
+}
+
+void StripCanvas::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+  fillRect(x, y, 1, h, color);
+}
+
+void StripCanvas::fillScreen(uint16_t color) {
+  color = swapped(color, _swap);
+  int32_t n = _region.area();
+  for (int32_t i = 0; i < n; i++) _buffer[i] = color;
+}
+
+} // namespace ui
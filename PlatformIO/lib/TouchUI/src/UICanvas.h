@@ -0,0 +1,44 @@
+#pragma once
+
+#include <Adafruit_GFX.h>
+#include "UIRect.h"
+
+namespace ui {
+
+// Off-screen render target covering one strip of the screen.
+//
+// Widgets draw in absolute screen coordinates through the normal Adafruit GFX
+// API; anything outside the current region (and the clip rect, if set) is
+// dropped, and what lands inside is written into a packed RGB565 buffer that
+// the compositor pushes to the panel with a single address window.
+class StripCanvas : public Adafruit_GFX {
+public:
+  StripCanvas();
+
+  // Points the canvas at `region` backed by `buffer` (region.w * region.h
+  // pixels) and clears the clip rect.
+  void begin(const Rect& region, uint16_t* buffer);
+
+  // Limits drawing to `clip` within the region, until the next begin().
+  void setClip(const Rect& clip) { _clip = _region.intersect(clip); }
+
+  // Store colors byte-swapped, for targets that DMA the buffer as-is.
+  void setSwapBytes(bool swap) { _swap = swap; }
+
+  const Rect& region() const { return _region; }
+  uint16_t* buffer() const   { return _buffer; }
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+  void fillScreen(uint16_t color) override;
+
+private:
+  Rect _region;
+  Rect _clip;
+  uint16_t* _buffer;
+  bool _swap;
+};
+
+} // namespace ui
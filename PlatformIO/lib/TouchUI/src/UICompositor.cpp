@@ -0,0 +1,120 @@
+#include "UICompositor.h"
+#include <esp_heap_caps.h>
+
+namespace ui {
+
+Compositor::Compositor(FlushTarget& target)
+  : _target(target), _screen(nullptr), _dirtyCount(0), _nextBuffer(0),
+    _lastPixels(0), _lastRects(0) {
+  _canvas.setSwapBytes(target.swapBytes());
+
+  // Each compositor has its own strips, in internal RAM so the SPI driver
+  // can DMA them directly
+  for (int i = 0; i < 2; i++) {
+    _strips[i] = (uint16_t*)heap_caps_malloc(UI_STRIP_PIXELS * 2, MALLOC_CAP_DMA);
+  }
+}
+
+Compositor::~Compositor() {
+  _target.finish();
+  for (int i = 0; i < 2; i++) heap_caps_free(_strips[i]);
+}
+
+void Compositor::show(Screen& screen) {
+  if (_screen) _screen->_compositor = nullptr;
+  _screen = &screen;
+  _screen->_compositor = this;
+  _dirtyCount = 0;
+  invalidate(screenRect());
+}
+
+void Compositor::touch(bool pressed, int16_t x, int16_t y) {
+  if (_screen) _screen->touch(pressed, x, y);
+}
+
+void Compositor::invalidate(const Rect& rect) {
+  Rect r = rect.intersect(screenRect());
+  if (r.empty()) return;
+
+  // Fold r into any rect it overlaps or sits close to, repeating until no
+  // more merges apply, so the list stays small and disjoint-ish.
+  uint8_t i = 0;
+  while (i < _dirtyCount) {
+    const Rect& d = _dirty[i];
+    if (d.contains(r)) return;
+
+    Rect u = d.unite(r);
+    if (u.area() <= d.area() + r.area() + UI_MERGE_SLACK) {
+      r = u;
+      _dirty[i] = _dirty[--_dirtyCount];
+      i = 0;
+      continue;
+    }
+    i++;
+  }
+
+  if (_dirtyCount < UI_MAX_DIRTY) {
+    _dirty[_dirtyCount++] = r;
+    return;
+  }
+
+  // List is full: grow whichever rect absorbs r with the least extra area
+  uint8_t best = 0;
+  int32_t bestGrowth = INT32_MAX;
+  for (i = 0; i < _dirtyCount; i++) {
+    int32_t growth = _dirty[i].unite(r).area() - _dirty[i].area();
+    if (growth < bestGrowth) {
+      bestGrowth = growth;
+      best = i;
+    }
+  }
+  _dirty[best] = _dirty[best].unite(r);
+}
+
+bool Compositor::update() {
+  _lastPixels = 0;
+  _lastRects = 0;
+  if (!_screen || _dirtyCount == 0 || !_strips[0] || !_strips[1]) return false;
+
+  // Take a snapshot so anything invalidated while drawing lands in the next frame
+  Rect dirty[UI_MAX_DIRTY];
+  uint8_t count = _dirtyCount;
+  for (uint8_t i = 0; i < count; i++) dirty[i] = _dirty[i];
+  _dirtyCount = 0;
+
+  for (uint8_t i = 0; i < count; i++) render(dirty[i]);
+  _lastRects = count;
+
+  // Nothing is left in flight once update() returns
+  _target.finish();
+  return true;
+}
+
+void Compositor::render(const Rect& dirty) {
+  int16_t rowsPerStrip = UI_STRIP_PIXELS / dirty.w;
+
+  for (int16_t y = dirty.y; y < dirty.bottom(); y += rowsPerStrip) {
+    int16_t rows = dirty.bottom() - y;
+    if (rows > rowsPerStrip) rows = rowsPerStrip;
+    Rect strip(dirty.x, y, dirty.w, rows);
+
+    // Alternate buffers: this one is filled while the previous strip is sent
+    uint16_t* buffer = _strips[_nextBuffer];
+    _nextBuffer ^= 1;
+
+    _canvas.begin(strip, buffer);
+    _canvas.fillScreen(_screen->background());
+    for (uint8_t n = 0; n < _screen->count(); n++) {
+      Widget* w = _screen->widget(n);
+      if (!w->visible() || !w->bounds().intersects(strip)) continue;
+      // Widgets only repaint their own bounds, so nothing may land outside
+      _canvas.setClip(w->bounds());
+      w->draw(_canvas, strip);
+    }
+
+    _target.pushRect(strip, buffer);
+    _lastPixels += strip.area();
+  }
+}
+
+} // namespace ui
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "UICanvas.h"
+#include "UIFlushTarget.h"
+#include "UIScreen.h"
+
+// Pixels per strip buffer (each compositor keeps two). 320 x 16 lines =
+// 10 KB each.
+#ifndef UI_STRIP_PIXELS
+#define UI_STRIP_PIXELS (UI_SCREEN_WIDTH * 16)
+#endif
+// Dirty rectangles tracked per frame before they get folded together
+#ifndef UI_MAX_DIRTY
+#define UI_MAX_DIRTY 8
+#endif
+// Two rects are merged when their union wastes at most this many pixels;
+// cheaper than paying for another address window on the bus.
+#ifndef UI_MERGE_SLACK
+#define UI_MERGE_SLACK 512
+#endif
+
+namespace ui {
+
+// Accumulates invalidated areas of the visible screen and, on update(),
+// repaints only those: each dirty rect is cut into strips, every widget that
+// overlaps a strip draws into an off-screen canvas, and the strip goes out
+// to the panel as one block.
+class Compositor {
+public:
+  explicit Compositor(FlushTarget& target);
+  ~Compositor();
+
+  Compositor(const Compositor&) = delete;
+  Compositor& operator=(const Compositor&) = delete;
+
+  // Makes `screen` the visible one and schedules a full repaint.
+  void show(Screen& screen);
+  Screen* current() const { return _screen; }
+
+  // Forwards the raw touch state to the visible screen.
+  void touch(bool pressed, int16_t x, int16_t y);
+
+  void invalidate(const Rect& r);
+
+  // Repaints everything dirty and waits for the last strip to reach the
+  // panel; returns false if there was nothing to do (or the strip buffers
+  // could not be allocated).
+  bool update();
+
+  // Cost of the last update(), for profiling
+  uint32_t lastPixels() const { return _lastPixels; }
+  uint8_t lastRects() const   { return _lastRects; }
+
+private:
+  void render(const Rect& dirty);
+
+  FlushTarget& _target;
+  Screen* _screen;
+  StripCanvas _canvas;
+  uint16_t* _strips[2];
+  Rect _dirty[UI_MAX_DIRTY];
+  uint8_t _dirtyCount;
+  uint8_t _nextBuffer;
+  uint32_t _lastPixels;
+  uint8_t _lastRects;
+};
+
+} // namespace ui
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <TFTDisplay.h>
+#include "UIFlushTarget.h"
+
+namespace ui {
+
+// Flush target for the shared DMA driver: strips are composed in panel byte
+// order and queued, so the compositor fills one strip while the other is sent.
+class DisplayTarget : public FlushTarget {
+public:
+  explicit DisplayTarget(TFTDisplay& tft) : _tft(tft) {}
+
+  void pushRect(const Rect& r, const uint16_t* pixels) override {
+    _tft.pushRect(r.x, r.y, r.w, r.h, pixels);
+  }
+
+  void finish() override { _tft.waitIdle(); }
+  bool swapBytes() const override { return true; }
+
+private:
+  TFTDisplay& _tft;
+};
+
+} // namespace ui
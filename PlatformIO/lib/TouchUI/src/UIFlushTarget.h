@@ -0,0 +1,35 @@
+#pragma once
+
+#include <Adafruit_SPITFT.h>
+#include "UIRect.h"
+
+namespace ui {
+
+// Where composed strips end up. pushRect() may return before the transfer is
+// finished, but must not return until the block pushed *before* this one is
+// done, so the compositor can refill that buffer while this one is sent.
+class FlushTarget {
+public:
+  virtual ~FlushTarget() {}
+  virtual void pushRect(const Rect& r, const uint16_t* pixels) = 0;
+  // True if pixels must be composed most significant byte first.
+  virtual bool swapBytes() const { return false; }
+  // Blocks until every pushed block has reached the panel.
+  virtual void finish() {}
+};
+
+// Blocking adapter for any Adafruit SPI display (Adafruit_ILI9341, ...):
+// one address window per block, then the pixels in a single burst.
+class SPITFTTarget : public FlushTarget {
+public:
+  explicit SPITFTTarget(Adafruit_SPITFT& tft) : _tft(tft) {}
+
+  void pushRect(const Rect& r, const uint16_t* pixels) override {
+    _tft.drawRGBBitmap(r.x, r.y, const_cast<uint16_t*>(pixels), r.w, r.h);
+  }
+
+private:
+  Adafruit_SPITFT& _tft;
+};
+
+} // namespace ui
@@ -0,0 +1,31 @@
+#include "UIHitGrid.h"
+
+#include <string.h>
+
+namespace ui {
+
+void HitGrid::clear() {
+  memset(_cells, 0, sizeof(_cells));
+}
+
+void HitGrid::insert(uint8_t slot, const Rect& bounds) {
+  Rect r = bounds.intersect(screenRect());
+  if (r.empty()) return;
+
+  int col0 = r.x / UI_GRID_CELL;
+  int col1 = (r.right() - 1) / UI_GRID_CELL;
+  int row0 = r.y / UI_GRID_CELL;
+  int row1 = (r.bottom() - 1) / UI_GRID_CELL;
+
+  uint32_t bit = 1UL << slot;
+  for (int row = row0; row <= row1; row++) {
+    for (int col = col0; col <= col1; col++) _cells[row][col] |= bit;
+  }
+}
+
+uint32_t HitGrid::candidates(int16_t x, int16_t y) const {
+  if (x < 0 || y < 0 || x >= UI_SCREEN_WIDTH || y >= UI_SCREEN_HEIGHT) return 0;
+  return _cells[y / UI_GRID_CELL][x / UI_GRID_CELL];
+}
+
+} // namespace ui
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "UIRect.h"
+
+// Hit-test bucket size in pixels (320x240 -> 8x6 buckets)
+#ifndef UI_GRID_CELL
+#define UI_GRID_CELL 40
+#endif
+
+namespace ui {
+
+// Uniform grid over the screen; each bucket holds a bitmask of the widget
+// slots (max 32) whose bounds overlap it. A touch looks up one bucket and
+// only tests those widgets instead of walking the whole screen.
+class HitGrid {
+public:
+  static const int COLS = (UI_SCREEN_WIDTH + UI_GRID_CELL - 1) / UI_GRID_CELL;
+  static const int ROWS = (UI_SCREEN_HEIGHT + UI_GRID_CELL - 1) / UI_GRID_CELL;
+
+  HitGrid() { clear(); }
+
+  void clear();
+  void insert(uint8_t slot, const Rect& bounds);
+
+  // Bitmask of slots that may contain (x, y); 0 when off-screen.
+  uint32_t candidates(int16_t x, int16_t y) const;
+
+private:
+  uint32_t _cells[ROWS][COLS];
+};
+
+} // namespace ui
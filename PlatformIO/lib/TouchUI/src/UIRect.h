@@ -0,0 +1,66 @@
+#pragma once
+
+#include <stdint.h>
+
+// Logical screen size after setRotation(1) (landscape), shared by every project.
+#ifndef UI_SCREEN_WIDTH
+#define UI_SCREEN_WIDTH  320
+#endif
+#ifndef UI_SCREEN_HEIGHT
+#define UI_SCREEN_HEIGHT 240
+#endif
+
+namespace ui {
+
+// Axis-aligned rectangle in screen pixels. An empty rect has w or h <= 0.
+struct Rect {
+  int16_t x;
+  int16_t y;
+  int16_t w;
+  int16_t h;
+
+  Rect() : x(0), y(0), w(0), h(0) {}
+  Rect(int16_t x, int16_t y, int16_t w, int16_t h) : x(x), y(y), w(w), h(h) {}
+
+  int16_t right() const  { return x + w; }
+  int16_t bottom() const { return y + h; }
+  bool empty() const     { return w <= 0 || h <= 0; }
+  int32_t area() const   { return empty() ? 0 : (int32_t)w * h; }
+
+  bool contains(int16_t px, int16_t py) const {
+    return px >= x && py >= y && px < right() && py < bottom();
+  }
+
+  bool contains(const Rect& r) const {
+    return r.x >= x && r.y >= y && r.right() <= right() && r.bottom() <= bottom();
+  }
+
+  bool intersects(const Rect& r) const {
+    return !empty() && !r.empty() &&
+           r.x < right() && x < r.right() && r.y < bottom() && y < r.bottom();
+  }
+
+  Rect intersect(const Rect& r) const {
+    int16_t l = x > r.x ? x : r.x;
+    int16_t t = y > r.y ? y : r.y;
+    int16_t rr = right() < r.right() ? right() : r.right();
+    int16_t bb = bottom() < r.bottom() ? bottom() : r.bottom();
+    if (rr <= l || bb <= t) return Rect();
+    return Rect(l, t, rr - l, bb - t);
+  }
+
+  // Smallest rect covering both; an empty operand is ignored.
+  Rect unite(const Rect& r) const {
+    if (empty()) return r;
+    if (r.empty()) return *this;
+    int16_t l = x < r.x ? x : r.x;
+    int16_t t = y < r.y ? y : r.y;
+    int16_t rr = right() > r.right() ? right() : r.right();
+    int16_t bb = bottom() > r.bottom() ? bottom() : r.bottom();
+    return Rect(l, t, rr - l, bb - t);
+  }
+};
+
+inline Rect screenRect() { return Rect(0, 0, UI_SCREEN_WIDTH, UI_SCREEN_HEIGHT); }
+
+} // namespace ui
@@ -0,0 +1,86 @@
+#include "UIScreen.h"
+#include "UICompositor.h"
+
+namespace ui {
+
+Screen::Screen(uint16_t background)
+  : _count(0), _touchMask(0), _background(background),
+    _captured(nullptr), _wasPressed(false), _lastX(0), _lastY(0),
+    _compositor(nullptr) {}
+
+bool Screen::add(Widget& widget) {
+  if (_count >= UI_MAX_WIDGETS || widget._screen) return false;
+
+  uint8_t slot = _count++;
+  _widgets[slot] = &widget;
+  widget._screen = this;
+  if (widget.touchable()) {
+    _touchMask |= 1UL << slot;
+    _grid.insert(slot, widget.bounds());
+  }
+  widget.invalidate();
+  return true;
+}
+
+void Screen::setBackground(uint16_t color) {
+  if (color == _background) return;
+  _background = color;
+  invalidateAll();
+}
+
+Widget* Screen::hitTest(int16_t x, int16_t y) const {
+  uint32_t mask = _grid.candidates(x, y) & _touchMask;
+
+  // Highest slot first: later widgets are drawn on top
+  while (mask) {
+    uint8_t slot = 31 - __builtin_clz(mask);
+    Widget* w = _widgets[slot];
+    if (w->visible() && w->bounds().contains(x, y)) return w;
+    mask &= ~(1UL << slot);
+  }
+  return nullptr;
+}
+
+void Screen::touch(bool pressed, int16_t x, int16_t y) {
+  TouchEvent ev;
+  ev.x = x;
+  ev.y = y;
+
+  if (pressed && !_wasPressed) {
+    _captured = hitTest(x, y);
+    ev.type = TouchEvent::DOWN;
+  } else if (pressed) {
+    ev.type = TouchEvent::MOVE;
+  } else if (_wasPressed) {
+    // Release has no position of its own, report where the finger left
+    ev.type = TouchEvent::UP;
+    ev.x = _lastX;
+    ev.y = _lastY;
+  } else {
+    return;
+  }
+  _wasPressed = pressed;
+  _lastX = ev.x;
+  _lastY = ev.y;
+
+  Widget* target = _captured;
+  if (!pressed) _captured = nullptr;
+  if (target) target->onTouch(ev);
+}
+
+void Screen::invalidate(const Rect& r) {
+  if (_compositor) _compositor->invalidate(r);
+}
+
+void Screen::invalidateAll() {
+  invalidate(screenRect());
+}
+
+void Screen::reindex() {
+  _grid.clear();
+  for (uint8_t slot = 0; slot < _count; slot++) {
+    if (_touchMask & (1UL << slot)) _grid.insert(slot, _widgets[slot]->bounds());
+  }
+}
+
+} // namespace ui
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "UIHitGrid.h"
+#include "UIWidgets.h"
+
+#ifndef UI_MAX_WIDGETS
+#define UI_MAX_WIDGETS 32 // one bit per widget in the hit grid
+#endif
+static_assert(UI_MAX_WIDGETS <= 32, "UI_MAX_WIDGETS must fit the 32-bit hit masks");
+
+namespace ui {
+
+class Compositor;
+
+// A page of widgets drawn over a solid background. Widgets are painted and
+// hit-tested in the order they were added, later ones on top.
+class Screen {
+public:
+  explicit Screen(uint16_t background = COLOR_BLACK);
+
+  // Widgets must outlive the screen. Returns false when the screen is full.
+  bool add(Widget& widget);
+
+  uint16_t background() const { return _background; }
+  void setBackground(uint16_t color);
+
+  uint8_t count() const           { return _count; }
+  Widget* widget(uint8_t i) const { return _widgets[i]; }
+
+  // Topmost visible, touchable widget under (x, y), or nullptr.
+  Widget* hitTest(int16_t x, int16_t y) const;
+
+  // Feed the raw touch state once per loop; generates DOWN/MOVE/UP events
+  // and routes them to the widget the touch started on.
+  void touch(bool pressed, int16_t x, int16_t y);
+
+  // Marks part of the screen for repaint (no-op while the screen is hidden).
+  void invalidate(const Rect& r);
+  void invalidateAll();
+
+  // Rebuilds the hit grid after a widget changed its bounds.
+  void reindex();
+
+private:
+  friend class Compositor;
+
+  Widget* _widgets[UI_MAX_WIDGETS];
+  uint8_t _count;
+  uint32_t _touchMask;
+  uint16_t _background;
+  HitGrid _grid;
+  Widget* _captured;
+  bool _wasPressed;
+  int16_t _lastX, _lastY;
+  Compositor* _compositor;
+};
+
+} // namespace ui
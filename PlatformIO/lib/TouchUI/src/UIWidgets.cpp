@@ -0,0 +1,322 @@
+#include "UIWidgets.h"
+#include "UIScreen.h"
+
+#include <stdio.h>
+#include <string.h>
+
+namespace ui {
+
+uint16_t heatColor(float rel) {
+  if (rel < 0.0f) rel = 0.0f;
+  if (rel > 1.0f) rel = 1.0f;
+
+  uint8_t r = 0, g = 0, b = 0;
+
+  // Cold (0.0 to 0.5): Blue fades to Green
+  // Hot (0.5 to 1.0): Green fades to Red
+  if (rel < 0.5f) {
+    float localRel = rel * 2.0f;
+    b = 255 * (1.0f - localRel);
+    g = 255 * localRel;
+  } else {
+    float localRel = (rel - 0.5f) * 2.0f;
+    g = 255 * (1.0f - localRel);
+    r = 255 * localRel;
+  }
+
+  return color565(r, g, b);
+}
+
+// -------------------------------------------------------------------
+// Widget
+// -------------------------------------------------------------------
+
+Widget::Widget(const Rect& bounds)
+  : _bounds(bounds), _visible(true), _touchable(false), _screen(nullptr) {}
+
+void Widget::setBounds(const Rect& bounds) {
+  invalidate();
+  _bounds = bounds;
+  invalidate();
+  if (_screen) _screen->reindex();
+}
+
+void Widget::setVisible(bool visible) {
+  if (visible == _visible) return;
+  _visible = visible;
+  invalidate();
+}
+
+void Widget::invalidate() {
+  invalidate(_bounds);
+}
+
+void Widget::invalidate(const Rect& r) {
+  if (_screen) _screen->invalidate(r.intersect(_bounds));
+}
+
+// -------------------------------------------------------------------
+// Label
+// -------------------------------------------------------------------
+
+Label::Label(const Rect& bounds, const char* text, uint16_t color)
+  : Widget(bounds), _color(color), _background(COLOR_BLACK), _opaque(false),
+    _font(nullptr), _size(1), _align(LEFT), _measured(false),
+    _textX(0), _textY(0), _textW(0), _textH(0) {
+  strncpy(_text, text, UI_TEXT_MAX - 1);
+  _text[UI_TEXT_MAX - 1] = '\0';
+}
+
+void Label::setText(const char* text) {
+  if (strncmp(_text, text, UI_TEXT_MAX - 1) == 0) return;
+  strncpy(_text, text, UI_TEXT_MAX - 1);
+  _text[UI_TEXT_MAX - 1] = '\0';
+  _measured = false;
+  invalidate();
+}
+
+void Label::setColor(uint16_t color) {
+  if (color == _color) return;
+  _color = color;
+  invalidate();
+}
+
+void Label::setBackground(uint16_t color) {
+  _background = color;
+  _opaque = true;
+  invalidate();
+}
+
+void Label::setFont(const GFXfont* font) {
+  _font = font;
+  _measured = false;
+  invalidate();
+}
+
+void Label::setTextSize(uint8_t size) {
+  _size = size;
+  _measured = false;
+  invalidate();
+}
+
+void Label::setAlign(Align align) {
+  _align = align;
+  invalidate();
+}
+
+void Label::draw(Adafruit_GFX& g, const Rect& clip) {
+  if (_opaque) g.fillRect(_bounds.x, _bounds.y, _bounds.w, _bounds.h, _background);
+  drawText(g, _color);
+}
+
+void Label::drawText(Adafruit_GFX& g, uint16_t color) {
+  g.setFont(_font);
+  g.setTextSize(_size);
+  g.setTextWrap(false);
+  g.setTextColor(color);
+
+  if (!_measured) {
+    g.getTextBounds(_text, 0, 0, &_textX, &_textY, &_textW, &_textH);
+    _measured = true;
+  }
+
+  // getTextBounds() is relative to the cursor, which is the baseline for
+  // GFX fonts and the top-left corner for the built-in font
+  int16_t x = _bounds.x - _textX;
+  if (_align == CENTER) x += (_bounds.w - (int16_t)_textW) / 2;
+  else if (_align == RIGHT) x += _bounds.w - (int16_t)_textW;
+  int16_t y = _bounds.y - _textY + (_bounds.h - (int16_t)_textH) / 2;
+
+  g.setCursor(x, y);
+  g.print(_text);
+}
+
+// -------------------------------------------------------------------
+// Button
+// -------------------------------------------------------------------
+
+Button::Button(const Rect& bounds, const char* text, Callback onPress)
+  : Label(bounds, text, COLOR_WHITE), _onPress(onPress),
+    _fill(COLOR_NAVY), _pressedFill(COLOR_DARKGREY), _border(COLOR_WHITE),
+    _pressed(false) {
+  _touchable = true;
+  _align = CENTER;
+}
+
+void Button::setColors(uint16_t fill, uint16_t pressedFill, uint16_t border) {
+  _fill = fill;
+  _pressedFill = pressedFill;
+  _border = border;
+  invalidate();
+}
+
+void Button::draw(Adafruit_GFX& g, const Rect& clip) {
+  g.fillRoundRect(_bounds.x, _bounds.y, _bounds.w, _bounds.h, 4, _pressed ? _pressedFill : _fill);
+  g.drawRoundRect(_bounds.x, _bounds.y, _bounds.w, _bounds.h, 4, _border);
+  drawText(g, _color);
+}
+
+void Button::onTouch(const TouchEvent& ev) {
+  switch (ev.type) {
+    case TouchEvent::DOWN:
+      setPressed(true);
+      break;
+    case TouchEvent::MOVE:
+      // Sliding off the button cancels the press, sliding back re-arms it
+      setPressed(_bounds.contains(ev.x, ev.y));
+      break;
+    case TouchEvent::UP:
+      if (_pressed && _onPress) _onPress(*this);
+      setPressed(false);
+      break;
+  }
+}
+
+void Button::setPressed(bool pressed) {
+  if (pressed == _pressed) return;
+  _pressed = pressed;
+  invalidate();
+}
+
+// -------------------------------------------------------------------
+// ValueField
+// -------------------------------------------------------------------
+
+ValueField::ValueField(const Rect& bounds, const char* prefix, const char* suffix,
+                       uint8_t decimals, uint16_t color)
+  : Label(bounds, "", color), _prefix(prefix), _suffix(suffix),
+    _decimals(decimals), _value(0.0f) {
+  setValue(0.0f);
+}
+
+void ValueField::setValue(float value) {
+  _value = value;
+  char text[UI_TEXT_MAX];
+  snprintf(text, sizeof(text), "%s%.*f%s", _prefix, _decimals, value, _suffix);
+  setText(text);
+}
+
+// -------------------------------------------------------------------
+// ThermalView
+// -------------------------------------------------------------------
+
+ThermalView::ThermalView(const Rect& bounds, uint8_t cols, uint8_t rows)
+  : Widget(bounds), _cols(cols ? cols : 1), _rows(rows ? rows : 1) {
+  // The color array holds UI_THERMAL_MAX_CELLS: a larger grid loses rows
+  if (_cols * _rows > UI_THERMAL_MAX_CELLS) {
+    _rows = UI_THERMAL_MAX_CELLS / _cols;
+    if (_rows == 0) {
+      _rows = 1;
+      _cols = (uint8_t)UI_THERMAL_MAX_CELLS; // only reached when it is below 256
+    }
+  }
+  // Bounds narrower than the grid still get 1-pixel cells (the cells past
+  // the edge are never drawn) rather than a zero size to divide by
+  _cellW = bounds.w > _cols ? bounds.w / _cols : 1;
+  _cellH = bounds.h > _rows ? bounds.h / _rows : 1;
+  memset(_colors, 0, sizeof(_colors));
+}
+
+void ThermalView::setFrame(const float* frame, float minTemp, float maxTemp) {
+  float span = maxTemp - minTemp;
+  if (span < 1.0f) span = 1.0f;
+
+  // Track the bounding box of changed cells so a still scene costs nothing
+  int16_t minCol = _cols, maxCol = -1, minRow = _rows, maxRow = -1;
+
+  for (uint8_t h = 0; h < _rows; h++) {
+    for (uint8_t w = 0; w < _cols; w++) {
+      int i = h * _cols + w;
+      uint16_t color = heatColor((frame[i] - minTemp) / span);
+      if (color == _colors[i]) continue;
+      _colors[i] = color;
+      if (w < minCol) minCol = w;
+      if (w > maxCol) maxCol = w;
+      if (h < minRow) minRow = h;
+      if (h > maxRow) maxRow = h;
+    }
+  }
+
+  if (maxCol < 0) return;
+  invalidate(Rect(_bounds.x + minCol * _cellW, _bounds.y + minRow * _cellH,
+                  (maxCol - minCol + 1) * _cellW, (maxRow - minRow + 1) * _cellH));
+}
+
+void ThermalView::draw(Adafruit_GFX& g, const Rect& clip) {
+  // Only walk the cells that overlap the strip being composed
+  Rect r = clip.intersect(_bounds);
+  if (r.empty()) return;
+
+  int16_t col0 = (r.x - _bounds.x) / _cellW;
+  int16_t col1 = (r.right() - 1 - _bounds.x) / _cellW;
+  int16_t row0 = (r.y - _bounds.y) / _cellH;
+  int16_t row1 = (r.bottom() - 1 - _bounds.y) / _cellH;
+  if (col1 >= _cols) col1 = _cols - 1;
+  if (row1 >= _rows) row1 = _rows - 1;
+
+  for (int16_t h = row0; h <= row1; h++) {
+    for (int16_t w = col0; w <= col1; w++) {
+      g.fillRect(_bounds.x + w * _cellW, _bounds.y + h * _cellH, _cellW, _cellH,
+                 _colors[h * _cols + w]);
+    }
+  }
+}
+
+// -------------------------------------------------------------------
+// Graph
+// -------------------------------------------------------------------
+
+Graph::Graph(const Rect& bounds, float minValue, float maxValue, uint16_t color)
+  : Widget(bounds), _head(0), _count(0), _min(minValue), _max(maxValue), _color(color) {}
+
+void Graph::push(float value) {
+  _samples[_head] = value;
+  _head = (_head + 1) % UI_GRAPH_CAPACITY;
+  if (_count < UI_GRAPH_CAPACITY) _count++;
+  invalidate();
+}
+
+void Graph::clear() {
+  _head = 0;
+  _count = 0;
+  invalidate();
+}
+
+void Graph::setRange(float minValue, float maxValue) {
+  if (minValue == _min && maxValue == _max) return;
+  _min = minValue;
+  _max = maxValue;
+  invalidate();
+}
+
+int16_t Graph::valueToY(float value) const {
+  float span = _max - _min;
+  if (span <= 0.0f) span = 1.0f;
+  float rel = (value - _min) / span;
+  if (rel < 0.0f) rel = 0.0f;
+  if (rel > 1.0f) rel = 1.0f;
+  return _bounds.bottom() - 1 - (int16_t)(rel * (_bounds.h - 1));
+}
+
+void Graph::draw(Adafruit_GFX& g, const Rect& clip) {
+  g.fillRect(_bounds.x, _bounds.y, _bounds.w, _bounds.h, COLOR_BLACK);
+  g.drawRect(_bounds.x, _bounds.y, _bounds.w, _bounds.h, COLOR_DARKGREY);
+  if (_count < 2) return;
+
+  // Oldest sample on the left, newest on the right edge
+  uint8_t first = (_head + UI_GRAPH_CAPACITY - _count) % UI_GRAPH_CAPACITY;
+  int16_t step = (_bounds.w - 2) / (UI_GRAPH_CAPACITY - 1);
+  if (step < 1) step = 1;
+  int16_t x = _bounds.right() - 2 - (_count - 1) * step;
+  int16_t y = valueToY(_samples[first]);
+
+  for (uint8_t n = 1; n < _count; n++) {
+    int16_t nx = x + step;
+    int16_t ny = valueToY(_samples[(first + n) % UI_GRAPH_CAPACITY]);
+    g.drawLine(x, y, nx, ny, _color);
+    x = nx;
+    y = ny;
+  }
+}
+
+} // namespace ui
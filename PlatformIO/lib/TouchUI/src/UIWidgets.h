@@ -0,0 +1,214 @@
+#pragma once
+
+#include <Adafruit_GFX.h>
+#include "UIRect.h"
+
+// Fixed capacities so widgets never touch the heap after construction
+#ifndef UI_TEXT_MAX
+#define UI_TEXT_MAX 40
+#endif
+#ifndef UI_THERMAL_MAX_CELLS
+#define UI_THERMAL_MAX_CELLS (32 * 24)
+#endif
+#ifndef UI_GRAPH_CAPACITY
+#define UI_GRAPH_CAPACITY 64
+#endif
+
+namespace ui {
+
+class Screen;
+
+// RGB565 colors used as widget defaults (same values as ILI9341_*)
+const uint16_t COLOR_BLACK    = 0x0000;
+const uint16_t COLOR_WHITE    = 0xFFFF;
+const uint16_t COLOR_DARKGREY = 0x7BEF;
+const uint16_t COLOR_NAVY     = 0x000F;
+const uint16_t COLOR_CYAN     = 0x07FF;
+
+inline uint16_t color565(uint8_t r, uint8_t g, uint8_t b) {
+  return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+}
+
+// Blue -> Green -> Red heatmap for rel in [0, 1]
+uint16_t heatColor(float rel);
+
+struct TouchEvent {
+  enum Type { DOWN, MOVE, UP };
+  Type type;
+  int16_t x;
+  int16_t y;
+};
+
+// -------------------------------------------------------------------
+// Widget: a rectangle that knows how to draw itself.
+// -------------------------------------------------------------------
+class Widget {
+public:
+  explicit Widget(const Rect& bounds);
+  virtual ~Widget() {}
+
+  const Rect& bounds() const { return _bounds; }
+  bool visible() const       { return _visible; }
+  bool touchable() const     { return _touchable; }
+
+  void setBounds(const Rect& bounds);
+  void setVisible(bool visible);
+
+  // Queue a repaint of the whole widget, or only part of it.
+  void invalidate();
+  void invalidate(const Rect& r);
+
+  // Draw into `g` using screen coordinates. Only pixels inside both `clip`
+  // and the widget's bounds reach the panel, so expensive widgets can skip
+  // the rest.
+  virtual void draw(Adafruit_GFX& g, const Rect& clip) = 0;
+
+  // Called for touches that start on this widget (only if touchable).
+  virtual void onTouch(const TouchEvent& ev) {}
+
+protected:
+  Rect _bounds;
+  bool _visible;
+  bool _touchable;
+
+private:
+  friend class Screen;
+  Screen* _screen;
+};
+
+// -------------------------------------------------------------------
+// Label: single line of text aligned inside its bounds.
+// -------------------------------------------------------------------
+class Label : public Widget {
+public:
+  enum Align { LEFT, CENTER, RIGHT };
+
+  Label(const Rect& bounds, const char* text = "", uint16_t color = COLOR_WHITE);
+
+  const char* text() const { return _text; }
+
+  // Only invalidates when the text actually changes.
+  void setText(const char* text);
+  void setColor(uint16_t color);
+  void setBackground(uint16_t color);
+  void setFont(const GFXfont* font);
+  void setTextSize(uint8_t size);
+  void setAlign(Align align);
+
+  void draw(Adafruit_GFX& g, const Rect& clip) override;
+
+protected:
+  void drawText(Adafruit_GFX& g, uint16_t color);
+
+  char _text[UI_TEXT_MAX];
+  uint16_t _color;
+  uint16_t _background;
+  bool _opaque;
+  const GFXfont* _font;
+  uint8_t _size;
+  Align _align;
+
+  // Text extent cached from getTextBounds(), refreshed after text/font changes
+  bool _measured;
+  int16_t _textX, _textY;
+  uint16_t _textW, _textH;
+};
+
+// -------------------------------------------------------------------
+// Button: label with a border that fires a callback on release.
+// -------------------------------------------------------------------
+class Button : public Label {
+public:
+  typedef void (*Callback)(Button& button);
+
+  Button(const Rect& bounds, const char* text, Callback onPress = nullptr);
+
+  void setCallback(Callback onPress) { _onPress = onPress; }
+  void setColors(uint16_t fill, uint16_t pressedFill, uint16_t border);
+  bool pressed() const { return _pressed; }
+
+  void draw(Adafruit_GFX& g, const Rect& clip) override;
+  void onTouch(const TouchEvent& ev) override;
+
+private:
+  void setPressed(bool pressed);
+
+  Callback _onPress;
+  uint16_t _fill;
+  uint16_t _pressedFill;
+  uint16_t _border;
+  bool _pressed;
+};
+
+// -------------------------------------------------------------------
+// ValueField: "<prefix><value><suffix>" that redraws only when the
+// formatted text changes.
+// -------------------------------------------------------------------
+class ValueField : public Label {
+public:
+  ValueField(const Rect& bounds, const char* prefix, const char* suffix,
+             uint8_t decimals = 1, uint16_t color = COLOR_WHITE);
+
+  void setValue(float value);
+  float value() const { return _value; }
+
+private:
+  const char* _prefix;
+  const char* _suffix;
+  uint8_t _decimals;
+  float _value;
+};
+
+// -------------------------------------------------------------------
+// ThermalView: cols x rows temperature grid scaled up to its bounds.
+// Grids over UI_THERMAL_MAX_CELLS are cut to fewer rows; cells are at least
+// 1 pixel, so a grid bigger than its bounds shows only its top-left part.
+// -------------------------------------------------------------------
+class ThermalView : public Widget {
+public:
+  ThermalView(const Rect& bounds, uint8_t cols = 32, uint8_t rows = 24);
+
+  // Colormaps `frame` (cols * rows, row-major) between minTemp and maxTemp and
+  // invalidates the bounding box of cells whose color changed.
+  void setFrame(const float* frame, float minTemp, float maxTemp);
+
+  uint8_t cols() const { return _cols; }
+  uint8_t rows() const { return _rows; }
+  int16_t cellWidth() const  { return _cellW; }
+  int16_t cellHeight() const { return _cellH; }
+
+  void draw(Adafruit_GFX& g, const Rect& clip) override;
+
+private:
+  uint8_t _cols;
+  uint8_t _rows;
+  int16_t _cellW;
+  int16_t _cellH;
+  uint16_t _colors[UI_THERMAL_MAX_CELLS];
+};
+
+// -------------------------------------------------------------------
+// Graph: scrolling line plot of the last UI_GRAPH_CAPACITY samples.
+// -------------------------------------------------------------------
+class Graph : public Widget {
+public:
+  Graph(const Rect& bounds, float minValue, float maxValue, uint16_t color = COLOR_CYAN);
+
+  void push(float value);
+  void clear();
+  void setRange(float minValue, float maxValue);
+
+  void draw(Adafruit_GFX& g, const Rect& clip) override;
+
+private:
+  int16_t valueToY(float value) const;
+
+  float _samples[UI_GRAPH_CAPACITY];
+  uint8_t _head;
+  uint8_t _count;
+  float _min;
+  float _max;
+  uint16_t _color;
+};
+
+} // namespace ui
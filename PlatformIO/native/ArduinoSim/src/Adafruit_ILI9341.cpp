@@ -0,0 +1,146 @@
+#include "Adafruit_ILI9341.h"
+#include "Sim.h"
+
+#define SPI_DEFAULT_FREQ 24000000
+
+#define MADCTL_MY  0x80
+#define MADCTL_MX  0x40
+#define MADCTL_MV  0x20
+#define MADCTL_BGR 0x08
+
+// Same sequence as the library (and TFTDisplay)
+static const uint8_t initcmd[] = {
+  0xEF, 3, 0x03, 0x80, 0x02,
+  0xCF, 3, 0x00, 0xC1, 0x30,
+  0xED, 4, 0x64, 0x03, 0x12, 0x81,
+  0xE8, 3, 0x85, 0x00, 0x78,
+  0xCB, 5, 0x39, 0x2C, 0x00, 0x34, 0x02,
+  0xF7, 1, 0x20,
+  0xEA, 2, 0x00, 0x00,
+  ILI9341_PWCTR1  , 1, 0x23,
+  ILI9341_PWCTR2  , 1, 0x10,
+  ILI9341_VMCTR1  , 2, 0x3e, 0x28,
+  ILI9341_VMCTR2  , 1, 0x86,
+  ILI9341_MADCTL  , 1, 0x48,
+  ILI9341_VSCRSADD, 1, 0x00,
+  ILI9341_PIXFMT  , 1, 0x55,
+  ILI9341_FRMCTR1 , 2, 0x00, 0x18,
+  ILI9341_DFUNCTR , 3, 0x08, 0x82, 0x27,
+  0xF2, 1, 0x00,
+  ILI9341_GAMMASET , 1, 0x01,
+  ILI9341_GMCTRP1 , 15, 0x0F, 0x31, 0x2B, 0x0C, 0x0E, 0x08,
+    0x4E, 0xF1, 0x37, 0x07, 0x10, 0x03, 0x0E, 0x09, 0x00,
+  ILI9341_GMCTRN1 , 15, 0x00, 0x0E, 0x14, 0x03, 0x11, 0x07,
+    0x31, 0xC1, 0x48, 0x08, 0x0F, 0x0C, 0x31, 0x36, 0x0F,
+  ILI9341_SLPOUT  , 0x80,
+  ILI9341_DISPON  , 0x80,
+  0x00
+};
+
+Adafruit_ILI9341::Adafruit_ILI9341(int8_t cs, int8_t dc, int8_t mosi, int8_t sclk, int8_t rst, int8_t miso)
+  : Adafruit_SPITFT(ILI9341_TFTWIDTH, ILI9341_TFTHEIGHT, cs, dc, rst), _panelCs(cs), _panelDc(dc) {}
+
+Adafruit_ILI9341::Adafruit_ILI9341(int8_t cs, int8_t dc, int8_t rst)
+  : Adafruit_SPITFT(ILI9341_TFTWIDTH, ILI9341_TFTHEIGHT, cs, dc, rst), _panelCs(cs), _panelDc(dc) {}
+
+Adafruit_ILI9341::Adafruit_ILI9341(SPIClass* spiClass, int8_t dc, int8_t cs, int8_t rst)
+  : Adafruit_SPITFT(ILI9341_TFTWIDTH, ILI9341_TFTHEIGHT, spiClass, cs, dc, rst), _panelCs(cs), _panelDc(dc) {}
+
+void Adafruit_ILI9341::begin(uint32_t freq) {
+  if (!freq) freq = SPI_DEFAULT_FREQ;
+  sim::panelAttach(_panelCs, _panelDc);
+  initSPI(freq);
+
+  if (_rst < 0) {
+    sendCommand(ILI9341_SWRESET);
+    delay(150);
+  }
+
+  uint8_t cmd, x, numArgs;
+  const uint8_t* addr = initcmd;
+  while ((cmd = pgm_read_byte(addr++)) > 0) {
+    x = pgm_read_byte(addr++);
+    numArgs = x & 0x7F;
+    sendCommand(cmd, addr, numArgs);
+    addr += numArgs;
+    if (x & 0x80) delay(150);
+  }
+
+  _width = ILI9341_TFTWIDTH;
+  _height = ILI9341_TFTHEIGHT;
+}
+
+void Adafruit_ILI9341::setRotation(uint8_t m) {
+  rotation = m % 4;
+  switch (rotation) {
+    case 0:
+      m = (MADCTL_MX | MADCTL_BGR);
+      _width = ILI9341_TFTWIDTH;
+      _height = ILI9341_TFTHEIGHT;
+      break;
+    case 1:
+      m = (MADCTL_MV | MADCTL_BGR);
+      _width = ILI9341_TFTHEIGHT;
+      _height = ILI9341_TFTWIDTH;
+      break;
+    case 2:
+      m = (MADCTL_MY | MADCTL_BGR);
+      _width = ILI9341_TFTWIDTH;
+      _height = ILI9341_TFTHEIGHT;
+      break;
+    case 3:
+      m = (MADCTL_MX | MADCTL_MY | MADCTL_MV | MADCTL_BGR);
+      _width = ILI9341_TFTHEIGHT;
+      _height = ILI9341_TFTWIDTH;
+      break;
+  }
+  sendCommand(ILI9341_MADCTL, &m, 1);
+}
+
+void Adafruit_ILI9341::invertDisplay(bool invert) {
+  sendCommand(invert ? ILI9341_INVON : ILI9341_INVOFF);
+}
+
+void Adafruit_ILI9341::scrollTo(uint16_t y) {
+  uint8_t data[2] = { (uint8_t)(y >> 8), (uint8_t)(y & 0xff) };
+  sendCommand(ILI9341_VSCRSADD, data, 2);
+}
+
+void Adafruit_ILI9341::setScrollMargins(uint16_t top, uint16_t bottom) {
+  if (top + bottom > ILI9341_TFTHEIGHT) return;
+  uint16_t middle = ILI9341_TFTHEIGHT - (top + bottom);
+  uint8_t data[6] = {
+    (uint8_t)(top >> 8), (uint8_t)(top & 0xff),
+    (uint8_t)(middle >> 8), (uint8_t)(middle & 0xff),
+    (uint8_t)(bottom >> 8), (uint8_t)(bottom & 0xff)
+  };
+  sendCommand(ILI9341_VSCRDEF, data, 6);
+}
+
+// Like the library, skips CASET/PASET when the range is unchanged
+void Adafruit_ILI9341::setAddrWindow(uint16_t x1, uint16_t y1, uint16_t w, uint16_t h) {
+  static uint16_t old_x1 = 0xffff, old_x2 = 0xffff;
+  static uint16_t old_y1 = 0xffff, old_y2 = 0xffff;
+
+  uint16_t x2 = (x1 + w - 1), y2 = (y1 + h - 1);
+  if (x1 != old_x1 || x2 != old_x2) {
+    writeCommand(ILI9341_CASET);
+    SPI_WRITE16(x1);
+    SPI_WRITE16(x2);
+    old_x1 = x1;
+    old_x2 = x2;
+  }
+  if (y1 != old_y1 || y2 != old_y2) {
+    writeCommand(ILI9341_PASET);
+    SPI_WRITE16(y1);
+    SPI_WRITE16(y2);
+    old_y1 = y1;
+    old_y2 = y2;
+  }
+  writeCommand(ILI9341_RAMWR);
+}
+
+// The emulated panel has nothing to read back
+uint8_t Adafruit_ILI9341::readcommand8(uint8_t reg, uint8_t index) {
+  return 0;
+}
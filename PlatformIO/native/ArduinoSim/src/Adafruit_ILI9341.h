@@ -0,0 +1,98 @@
+#pragma once
+
+#include "Arduino.h"
+#include <Adafruit_GFX.h>
+#include <Adafruit_SPITFT.h>
+#include <SPI.h>
+
+// Host build of Adafruit_ILI9341: the real Adafruit_SPITFT drawing code on
+// the simulated SPIClass, with the panel emulator listening on its CS/DC
+// pins. Also supplies the ILI9341_* names TFTDisplay uses.
+
+#define ILI9341_TFTWIDTH  240
+#define ILI9341_TFTHEIGHT 320
+
+#define ILI9341_NOP        0x00
+#define ILI9341_SWRESET    0x01
+#define ILI9341_RDDID      0x04
+#define ILI9341_RDDST      0x09
+#define ILI9341_SLPIN      0x10
+#define ILI9341_SLPOUT     0x11
+#define ILI9341_PTLON      0x12
+#define ILI9341_NORON      0x13
+#define ILI9341_RDMODE     0x0A
+#define ILI9341_RDMADCTL   0x0B
+#define ILI9341_RDPIXFMT   0x0C
+#define ILI9341_RDIMGFMT   0x0D
+#define ILI9341_RDSELFDIAG 0x0F
+#define ILI9341_INVOFF     0x20
+#define ILI9341_INVON      0x21
+#define ILI9341_GAMMASET   0x26
+#define ILI9341_DISPOFF    0x28
+#define ILI9341_DISPON     0x29
+#define ILI9341_CASET      0x2A
+#define ILI9341_PASET      0x2B
+#define ILI9341_RAMWR      0x2C
+#define ILI9341_RAMRD      0x2E
+#define ILI9341_PTLAR      0x30
+#define ILI9341_VSCRDEF    0x33
+#define ILI9341_MADCTL     0x36
+#define ILI9341_VSCRSADD   0x37
+#define ILI9341_PIXFMT     0x3A
+#define ILI9341_FRMCTR1    0xB1
+#define ILI9341_FRMCTR2    0xB2
+#define ILI9341_FRMCTR3    0xB3
+#define ILI9341_INVCTR     0xB4
+#define ILI9341_DFUNCTR    0xB6
+#define ILI9341_PWCTR1     0xC0
+#define ILI9341_PWCTR2     0xC1
+#define ILI9341_PWCTR3     0xC2
+#define ILI9341_PWCTR4     0xC3
+#define ILI9341_PWCTR5     0xC4
+#define ILI9341_VMCTR1     0xC5
+#define ILI9341_VMCTR2     0xC7
+#define ILI9341_RDID1      0xDA
+#define ILI9341_RDID2      0xDB
+#define ILI9341_RDID3      0xDC
+#define ILI9341_RDID4      0xDD
+#define ILI9341_GMCTRP1    0xE0
+#define ILI9341_GMCTRN1    0xE1
+
+#define ILI9341_BLACK       0x0000
+#define ILI9341_NAVY        0x000F
+#define ILI9341_DARKGREEN   0x03E0
+#define ILI9341_DARKCYAN    0x03EF
+#define ILI9341_MAROON      0x7800
+#define ILI9341_PURPLE      0x780F
+#define ILI9341_OLIVE       0x7BE0
+#define ILI9341_LIGHTGREY   0xC618
+#define ILI9341_DARKGREY    0x7BEF
+#define ILI9341_BLUE        0x001F
+#define ILI9341_GREEN       0x07E0
+#define ILI9341_CYAN        0x07FF
+#define ILI9341_RED         0xF800
+#define ILI9341_MAGENTA     0xF81F
+#define ILI9341_YELLOW      0xFFE0
+#define ILI9341_WHITE       0xFFFF
+#define ILI9341_ORANGE      0xFD20
+#define ILI9341_GREENYELLOW 0xAFE5
+#define ILI9341_PINK        0xFC18
+
+class Adafruit_ILI9341 : public Adafruit_SPITFT {
+public:
+  // Software SPI pins are accepted but the bytes still go through SPIClass
+  Adafruit_ILI9341(int8_t cs, int8_t dc, int8_t mosi, int8_t sclk, int8_t rst = -1, int8_t miso = -1);
+  Adafruit_ILI9341(int8_t cs, int8_t dc, int8_t rst = -1);
+  Adafruit_ILI9341(SPIClass* spiClass, int8_t dc, int8_t cs = -1, int8_t rst = -1);
+
+  void begin(uint32_t freq = 0);
+  void setRotation(uint8_t r);
+  void invertDisplay(bool i);
+  void scrollTo(uint16_t y);
+  void setScrollMargins(uint16_t top, uint16_t bottom);
+  void setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+  uint8_t readcommand8(uint8_t reg, uint8_t index = 0);
+
+private:
+  int8_t _panelCs, _panelDc;
+};
@@ -0,0 +1,173 @@
+#include "Adafruit_MLX90640.h"
+#include "Sim.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#define MLX90640_PIXELS 768
+#define MLX90640_COLS   32
+#define MLX90640_ROWS   24
+
+// Words per I2C read; the Wire buffer holds 128 bytes
+#define READ_CHUNK_WORDS 64
+
+// -------------------------------------------------------------------
+// FRAME SOURCES
+// -------------------------------------------------------------------
+
+static std::vector<float>& replayFrames() {
+  static std::vector<float> frames;
+  static bool loaded = false;
+  if (loaded) return frames;
+  loaded = true;
+
+  const char* path = getenv("MLX90640_REPLAY");
+  if (!path) return frames;
+  FILE* f = fopen(path, "r");
+  if (!f) {
+    fprintf(stderr, "MLX90640_REPLAY: cannot open %s, using the synthetic scene\n", path);
+    return frames;
+  }
+
+  char* line = nullptr;
+  size_t cap = 0;
+  int lineNo = 0;
+  while (getline(&line, &cap, f) > 0) {
+    lineNo++;
+    float values[MLX90640_PIXELS];
+    int n = 0;
+    char* p = line;
+    while (n < MLX90640_PIXELS) {
+      char* end;
+      float v = strtof(p, &end);
+      if (end == p) break;
+      values[n++] = v;
+      p = end;
+      while (*p == ',' || *p == ' ' || *p == '\t') p++;
+    }
+    if (n == MLX90640_PIXELS) {
+      frames.insert(frames.end(), values, values + MLX90640_PIXELS);
+    } else if (n > 0) {
+      fprintf(stderr, "MLX90640_REPLAY: line %d has %d values, skipped\n", lineNo, n);
+    }
+  }
+  free(line);
+  fclose(f);
+  return frames;
+}
+
+static void syntheticFrame(uint32_t index, float* out) {
+  float t = index * 0.15f;
+  float blobX = 16 + 11 * sinf(t);
+  float blobY = 12 + 7 * sinf(t * 0.7f + 1);
+  uint32_t noise = 0x1234567u + index * 7919u;
+
+  for (int y = 0; y < MLX90640_ROWS; y++) {
+    for (int x = 0; x < MLX90640_COLS; x++) {
+      float v = 22 + 4.0f * x / (MLX90640_COLS - 1);
+
+      float dx = x - blobX, dy = y - blobY;
+      v += 13 * expf(-(dx * dx + dy * dy) / (2 * 2.5f * 2.5f));
+
+      dx = x - 6.0f;
+      dy = y - 18.0f;
+      v += 7 * expf(-(dx * dx + dy * dy) / (2 * 1.2f * 1.2f));
+
+      noise = noise * 1664525u + 1013904223u;
+      v += ((noise >> 16) & 0xFF) / 255.0f * 0.3f - 0.15f;
+
+      out[y * MLX90640_COLS + x] = v;
+    }
+  }
+}
+
+// -------------------------------------------------------------------
+// DRIVER
+// -------------------------------------------------------------------
+
+Adafruit_MLX90640::Adafruit_MLX90640()
+  : _addr(MLX90640_I2CADDR_DEFAULT), _wire(nullptr), _mode(MLX90640_CHESS),
+    _resolution(MLX90640_ADC_18BIT), _rate(MLX90640_2_HZ), _frameCount(0) {
+  serialNumber[0] = serialNumber[1] = serialNumber[2] = 0;
+}
+
+bool Adafruit_MLX90640::readWords(uint16_t reg, uint16_t* words, size_t count) {
+  while (count) {
+    size_t n = count < READ_CHUNK_WORDS ? count : READ_CHUNK_WORDS;
+    _wire->beginTransmission(_addr);
+    _wire->write((uint8_t)(reg >> 8));
+    _wire->write((uint8_t)(reg & 0xFF));
+    if (_wire->endTransmission(false) != 0) return false;
+    if (_wire->requestFrom(_addr, n * 2, true) != n * 2) return false;
+    for (size_t i = 0; i < n; i++) {
+      uint16_t hi = _wire->read();
+      words[i] = (hi << 8) | _wire->read();
+    }
+    words += n;
+    reg += n;
+    count -= n;
+  }
+  return true;
+}
+
+bool Adafruit_MLX90640::writeWord(uint16_t reg, uint16_t value) {
+  _wire->beginTransmission(_addr);
+  _wire->write((uint8_t)(reg >> 8));
+  _wire->write((uint8_t)(reg & 0xFF));
+  _wire->write((uint8_t)(value >> 8));
+  _wire->write((uint8_t)(value & 0xFF));
+  return _wire->endTransmission() == 0;
+}
+
+bool Adafruit_MLX90640::begin(uint8_t i2c_addr, TwoWire* wire) {
+  _addr = i2c_addr;
+  _wire = wire;
+
+  _wire->beginTransmission(_addr);
+  if (_wire->endTransmission() != 0) return false;
+
+  // The driver dumps the whole EEPROM to extract its calibration
+  static uint16_t eeprom[832];
+  if (!readWords(0x2400, eeprom, 832)) return false;
+  memcpy(serialNumber, &eeprom[7], sizeof(serialNumber));
+  return true;
+}
+
+void Adafruit_MLX90640::setRefreshRate(mlx90640_refreshrate_t rate) {
+  _rate = rate;
+  uint16_t control;
+  if (_wire && readWords(0x800D, &control, 1)) {
+    writeWord(0x800D, (control & ~(0x07 << 7)) | ((rate & 0x07) << 7));
+  }
+}
+
+// 0 on success, like the library
+int Adafruit_MLX90640::getFrame(float* framebuf) {
+  if (!_wire) return -1;
+
+  // Two subpages per frame, each a half refresh period apart
+  float hz = 0.5f * (1 << _rate);
+  uint64_t subpageMicros = (uint64_t)(500000 / hz);
+  static uint16_t ram[834];
+  for (int page = 0; page < 2; page++) {
+    sim::advanceMicros(subpageMicros);
+    uint16_t status;
+    if (!readWords(0x8000, &status, 1)) return -1;
+    if (!readWords(0x0400, ram, 832)) return -1;
+    if (!readWords(0x800D, &ram[832], 1)) return -1;
+    if (!writeWord(0x8000, status & ~0x0008)) return -1;
+  }
+
+  sim::Overhead overhead;
+  std::vector<float>& frames = replayFrames();
+  if (!frames.empty()) {
+    size_t count = frames.size() / MLX90640_PIXELS;
+    memcpy(framebuf, &frames[(_frameCount % count) * MLX90640_PIXELS], MLX90640_PIXELS * sizeof(float));
+  } else {
+    syntheticFrame(_frameCount, framebuf);
+  }
+  _frameCount++;
+  return 0;
+}
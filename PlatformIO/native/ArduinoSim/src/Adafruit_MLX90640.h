@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Arduino.h"
+#include "Wire.h"
+
+#define MLX90640_I2CADDR_DEFAULT 0x33
+
+typedef enum mlx90640_mode {
+  MLX90640_INTERLEAVED,
+  MLX90640_CHESS,
+} mlx90640_mode_t;
+
+typedef enum mlx90640_res {
+  MLX90640_ADC_16BIT,
+  MLX90640_ADC_17BIT,
+  MLX90640_ADC_18BIT,
+  MLX90640_ADC_19BIT,
+} mlx90640_resolution_t;
+
+typedef enum mlx90640_refreshrate {
+  MLX90640_0_5_HZ,
+  MLX90640_1_HZ,
+  MLX90640_2_HZ,
+  MLX90640_4_HZ,
+  MLX90640_8_HZ,
+  MLX90640_16_HZ,
+  MLX90640_32_HZ,
+  MLX90640_64_HZ,
+} mlx90640_refreshrate_t;
+
+// Host build of Adafruit_MLX90640. The I2C traffic of the real driver (the
+// EEPROM dump in begin(), two subpages of RAM per getFrame()) goes over the
+// simulated Wire bus, and getFrame() waits one refresh period of virtual
+// time. The temperatures come from the CSV file named by MLX90640_REPLAY
+// (768 values per line, row-major, looping) or, without one, from a
+// synthetic scene: a warm gradient, a fixed 30 C spot and a 35 C blob that
+// wanders around, plus noise. Both are deterministic.
+class Adafruit_MLX90640 {
+public:
+  Adafruit_MLX90640();
+
+  bool begin(uint8_t i2c_addr = MLX90640_I2CADDR_DEFAULT, TwoWire* wire = &Wire);
+
+  mlx90640_mode_t getMode() { return _mode; }
+  void setMode(mlx90640_mode_t mode) { _mode = mode; }
+  mlx90640_resolution_t getResolution() { return _resolution; }
+  void setResolution(mlx90640_resolution_t res) { _resolution = res; }
+  mlx90640_refreshrate_t getRefreshRate() { return _rate; }
+  void setRefreshRate(mlx90640_refreshrate_t rate);
+
+  int getFrame(float* framebuf);
+
+  uint16_t serialNumber[3];
+
+private:
+  bool readWords(uint16_t reg, uint16_t* words, size_t count);
+  bool writeWord(uint16_t reg, uint16_t value);
+
+  uint8_t _addr;
+  TwoWire* _wire;
+  mlx90640_mode_t _mode;
+  mlx90640_resolution_t _resolution;
+  mlx90640_refreshrate_t _rate;
+  uint32_t _frameCount;
+};
@@ -0,0 +1,139 @@
+#include "Arduino.h"
+#include "Sim.h"
+#include "driver/gpio.h"
+
+#include <chrono>
+#include <stdlib.h>
+
+EspClass ESP;
+
+// -------------------------------------------------------------------
+// TIME
+// -------------------------------------------------------------------
+
+unsigned long millis() {
+  return (unsigned long)(uint32_t)(sim::nowMicros() / 1000);
+}
+
+unsigned long micros() {
+  return (unsigned long)(uint32_t)sim::nowMicros();
+}
+
+void delay(uint32_t ms) {
+  sim::advanceMicros((uint64_t)ms * 1000);
+}
+
+void delayMicroseconds(uint32_t us) {
+  sim::advanceMicros(us);
+}
+
+void yield() {}
+
+// -------------------------------------------------------------------
+// GPIO
+// -------------------------------------------------------------------
+
+#define NUM_PINS 64
+
+static uint8_t pinModes[NUM_PINS];
+static uint8_t pinLevels[NUM_PINS];
+static int lastLevel = HIGH;
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  if (pin < NUM_PINS) pinModes[pin] = mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+  if (pin < NUM_PINS) pinLevels[pin] = val ? HIGH : LOW;
+}
+
+// Outputs read back what was written; inputs float high (buttons released)
+// unless pulled down
+int digitalRead(uint8_t pin) {
+  if (pin >= NUM_PINS) return LOW;
+  if (pinModes[pin] == OUTPUT) return pinLevels[pin];
+  return pinModes[pin] == INPUT_PULLDOWN ? LOW : HIGH;
+}
+
+int analogRead(uint8_t pin) {
+  return 2048;
+}
+
+esp_err_t gpio_set_level(gpio_num_t gpio, uint32_t level) {
+  lastLevel = level ? HIGH : LOW;
+  if (gpio >= 0 && gpio < NUM_PINS) pinLevels[gpio] = lastLevel;
+  return ESP_OK;
+}
+
+int gpio_get_level(gpio_num_t gpio) {
+  return (gpio >= 0 && gpio < NUM_PINS) ? pinLevels[gpio] : 0;
+}
+
+int sim::lastGpioLevel() {
+  return lastLevel;
+}
+
+// -------------------------------------------------------------------
+// INTERRUPTS
+// -------------------------------------------------------------------
+
+static void callPlain(void* handler) {
+  reinterpret_cast<void (*)()>(handler)();
+}
+
+void attachInterrupt(uint8_t pin, void (*handler)(), int mode) {
+  sim::attachInterrupt(pin, callPlain, reinterpret_cast<void*>(handler), mode);
+}
+
+void attachInterruptArg(uint8_t pin, void (*handler)(void*), void* arg, int mode) {
+  sim::attachInterrupt(pin, handler, arg, mode);
+}
+
+void detachInterrupt(uint8_t pin) {
+  sim::detachInterrupt(pin);
+}
+
+// -------------------------------------------------------------------
+// MATH
+// -------------------------------------------------------------------
+
+long map(long x, long in_min, long in_max, long out_min, long out_max) {
+  if (in_max == in_min) return out_min;
+  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+// Seeded LCG so runs are reproducible
+static uint32_t randomState = 1;
+
+long random(long howbig) {
+  if (howbig <= 0) return 0;
+  randomState = randomState * 1664525u + 1013904223u;
+  return (randomState >> 8) % howbig;
+}
+
+long random(long howsmall, long howbig) {
+  if (howsmall >= howbig) return howsmall;
+  return random(howbig - howsmall) + howsmall;
+}
+
+void randomSeed(unsigned long seed) {
+  if (seed) randomState = seed;
+}
+
+// -------------------------------------------------------------------
+// ESP32 SPECIFICS
+// -------------------------------------------------------------------
+
+// Host time at a nominal 240 MHz, including virtual time, so cycle-counter
+// measurements (Telemetry) see the same sensor waits as on the device
+uint32_t EspClass::getCycleCount() {
+  return (uint32_t)(sim::nowMicros() * 240);
+}
+
+void EspClass::restart() {
+  exit(0);
+}
+
+uint32_t getCpuFrequencyMhz() {
+  return 240;
+}
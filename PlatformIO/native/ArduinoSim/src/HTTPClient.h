@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Arduino.h"
+#include "WiFi.h"
+
+#define HTTPC_ERROR_CONNECTION_REFUSED  (-1)
+#define HTTPC_ERROR_SEND_HEADER_FAILED  (-2)
+#define HTTPC_ERROR_SEND_PAYLOAD_FAILED (-3)
+#define HTTPC_ERROR_NOT_CONNECTED       (-4)
+#define HTTPC_ERROR_CONNECTION_LOST     (-5)
+#define HTTPC_ERROR_NO_STREAM           (-6)
+#define HTTPC_ERROR_NO_HTTP_SERVER      (-7)
+#define HTTPC_ERROR_TOO_LESS_RAM        (-8)
+#define HTTPC_ERROR_ENCODING            (-9)
+#define HTTPC_ERROR_STREAM_WRITE        (-10)
+#define HTTPC_ERROR_READ_TIMEOUT        (-11)
+
+#define HTTP_CODE_OK        200
+#define HTTP_CODE_NOT_FOUND 404
+
+// Serves recorded OpenWeatherMap /data/2.5/weather responses in rotation,
+// whatever the URL: a few built-in samples, or the file named by the
+// OWM_REPLAY environment variable (one JSON document per line). Each GET
+// costs 150 ms of virtual time.
+class HTTPClient {
+public:
+  HTTPClient() : _begun(false), _code(0) {}
+
+  bool begin(String url);
+  void end();
+  int GET();
+  String getString() { return _payload; }
+  int getSize() { return _payload.length(); }
+  bool connected() { return _begun; }
+
+  void addHeader(const String& name, const String& value, bool first = false, bool replace = true) {}
+  void setTimeout(uint16_t timeout) {}
+  void setConnectTimeout(int32_t timeout) {}
+  void setReuse(bool reuse) {}
+
+  static String errorToString(int error);
+
+private:
+  bool _begun;
+  int _code;
+  String _payload;
+};
@@ -0,0 +1,13 @@
+#include "HardwareSerial.h"
+#include "Sim.h"
+
+#include <stdio.h>
+
+HardwareSerial Serial;
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+  std::lock_guard<std::mutex> guard(_lock);
+  sim::counters.serialBytes += size;
+  if (sim::serialEcho()) fwrite(buffer, 1, size, stderr);
+  return size;
+}
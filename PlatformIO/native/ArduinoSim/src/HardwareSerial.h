@@ -0,0 +1,34 @@
+#pragma once
+
+#include <mutex>
+#include "Stream.h"
+
+// UART0 on the host. Output is counted (sim::counters.serialBytes) and
+// thrown away unless the benchmark was started with --serial, which echoes
+// it to stderr. Nothing is ever received.
+class HardwareSerial : public Stream {
+public:
+  void begin(unsigned long baud, uint32_t config = 0, int8_t rxPin = -1, int8_t txPin = -1) {}
+  void end() {}
+  size_t setTxBufferSize(size_t size) { return size; }
+  size_t setRxBufferSize(size_t size) { return size; }
+
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+  void flush() override {}
+
+  // The host never backs up: report a full, empty TX FIFO
+  int availableForWrite() override { return 4096; }
+
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* buffer, size_t size) override;
+  using Print::write;
+
+  operator bool() const { return true; }
+
+private:
+  std::mutex _lock; // the logger drains from its own thread
+};
+
+extern HardwareSerial Serial;
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "Print.h"
+
+class IPAddress : public Printable {
+public:
+  IPAddress() : IPAddress(0, 0, 0, 0) {}
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) {
+    _bytes[0] = a;
+    _bytes[1] = b;
+    _bytes[2] = c;
+    _bytes[3] = d;
+  }
+  IPAddress(uint32_t address) { memcpy(_bytes, &address, 4); }
+
+  operator uint32_t() const {
+    uint32_t address;
+    memcpy(&address, _bytes, 4);
+    return address;
+  }
+  uint8_t operator[](int index) const { return _bytes[index]; }
+  uint8_t& operator[](int index) { return _bytes[index]; }
+
+  bool fromString(const char* address);
+  String toString() const;
+  size_t printTo(Print& p) const override;
+
+private:
+  uint8_t _bytes[4];
+};
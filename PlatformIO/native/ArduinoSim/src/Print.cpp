@@ -0,0 +1,70 @@
+#include "Print.h"
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+  size_t n = 0;
+  while (size--) {
+    if (!write(*buffer++)) break;
+    n++;
+  }
+  return n;
+}
+
+size_t Print::printf(const char* format, ...) {
+  char stackBuf[64];
+  va_list args;
+  va_start(args, format);
+  int len = vsnprintf(stackBuf, sizeof(stackBuf), format, args);
+  va_end(args);
+  if (len < 0) return 0;
+  if ((size_t)len < sizeof(stackBuf)) return write(stackBuf, len);
+
+  char* heapBuf = (char*)malloc(len + 1);
+  if (!heapBuf) return 0;
+  va_start(args, format);
+  vsnprintf(heapBuf, len + 1, format, args);
+  va_end(args);
+  size_t n = write(heapBuf, len);
+  free(heapBuf);
+  return n;
+}
+
+size_t Print::print(long long value, int base) {
+  if (base == 0) return write((uint8_t)value);
+  if (base == 10 && value < 0) {
+    size_t n = print('-');
+    return n + printNumber(0ULL - (unsigned long long)value, 10);
+  }
+  return printNumber((unsigned long long)value, base);
+}
+
+size_t Print::print(unsigned long long value, int base) {
+  if (base == 0) return write((uint8_t)value);
+  return printNumber(value, base);
+}
+
+size_t Print::print(double value, int digits) {
+  if (isnan(value)) return print("nan");
+  if (isinf(value)) return print("inf");
+  char buf[64];
+  int len = snprintf(buf, sizeof(buf), "%.*f", digits, value);
+  if (len < 0 || (size_t)len >= sizeof(buf)) return print("ovf");
+  return write(buf, len);
+}
+
+size_t Print::printNumber(unsigned long long n, uint8_t base) {
+  char buf[8 * sizeof(n) + 1];
+  char* str = &buf[sizeof(buf) - 1];
+  *str = '\0';
+  if (base < 2) base = 10;
+  do {
+    char c = n % base;
+    n /= base;
+    *--str = c < 10 ? c + '0' : c + 'A' - 10;
+  } while (n);
+  return write(str);
+}
@@ -0,0 +1,32 @@
+#include "SPI.h"
+#include "Sim.h"
+
+SPIClass SPI;
+
+uint8_t SPIClass::transfer(uint8_t data) {
+  sim::spiTransfer(data);
+  return 0;
+}
+
+uint16_t SPIClass::transfer16(uint16_t data) {
+  transfer(data >> 8);
+  transfer(data);
+  return 0;
+}
+
+uint32_t SPIClass::transfer32(uint32_t data) {
+  transfer16(data >> 16);
+  transfer16(data);
+  return 0;
+}
+
+void SPIClass::transfer(void* data, uint32_t size) {
+  transferBytes((const uint8_t*)data, (uint8_t*)data, size);
+}
+
+void SPIClass::transferBytes(const uint8_t* data, uint8_t* out, uint32_t size) {
+  for (uint32_t i = 0; i < size; i++) {
+    transfer(data[i]);
+    if (out) out[i] = 0;
+  }
+}
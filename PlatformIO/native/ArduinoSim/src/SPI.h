@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Arduino.h"
+
+// SPIClass on the host: every byte goes to the emulated ILI9341 when the
+// pins registered with sim::panelAttach() select it (Adafruit_ILI9341) and
+// is counted either way. Reads return 0.
+
+#define SPI_HAS_TRANSACTION
+
+#define SPI_MODE0 0
+#define SPI_MODE1 1
+#define SPI_MODE2 2
+#define SPI_MODE3 3
+
+#define SPI_MSBFIRST 1
+#define SPI_LSBFIRST 0
+
+class SPISettings {
+public:
+  SPISettings() : _clock(1000000), _bitOrder(MSBFIRST), _dataMode(SPI_MODE0) {}
+  SPISettings(uint32_t clock, uint8_t bitOrder, uint8_t dataMode)
+    : _clock(clock), _bitOrder(bitOrder), _dataMode(dataMode) {}
+
+  uint32_t _clock;
+  uint8_t _bitOrder;
+  uint8_t _dataMode;
+};
+
+class SPIClass {
+public:
+  void begin(int8_t sck = -1, int8_t miso = -1, int8_t mosi = -1, int8_t ss = -1) {}
+  void end() {}
+
+  void beginTransaction(SPISettings settings) {}
+  void endTransaction() {}
+
+  void setFrequency(uint32_t freq) {}
+  void setClockDivider(uint32_t div) {}
+  void setBitOrder(uint8_t bitOrder) {}
+  void setDataMode(uint8_t dataMode) {}
+
+  uint8_t transfer(uint8_t data);
+  uint16_t transfer16(uint16_t data);
+  uint32_t transfer32(uint32_t data);
+  void transfer(void* data, uint32_t size);
+  void transferBytes(const uint8_t* data, uint8_t* out, uint32_t size);
+
+  void write(uint8_t data) { transfer(data); }
+  void write16(uint16_t data) { transfer16(data); }
+  void write32(uint32_t data) { transfer32(data); }
+  void writeBytes(const uint8_t* data, uint32_t size) { transferBytes(data, nullptr, size); }
+  void writePixels(const void* data, uint32_t size) { writeBytes((const uint8_t*)data, size); }
+};
+
+extern SPIClass SPI;
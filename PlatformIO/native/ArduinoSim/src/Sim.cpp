@@ -0,0 +1,333 @@
+#include "Sim.h"
+#include "Arduino.h"
+
+#include <atomic>
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+namespace sim {
+
+Counters counters;
+
+void resetCounters() {
+  counters = Counters();
+}
+
+// -------------------------------------------------------------------
+// TIME
+// -------------------------------------------------------------------
+
+static std::atomic<uint64_t> virtualMicros(0);
+
+uint64_t nowMicros() {
+  // Function-local so sketches can read the clock from their own static
+  // initializers (telemetry::addStage() does)
+  static const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+  auto elapsed = std::chrono::steady_clock::now() - startTime;
+  return std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() + virtualMicros.load();
+}
+
+void advanceMicros(uint64_t us) {
+  virtualMicros += us;
+}
+
+uint64_t threadNanos() {
+  timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+thread_local uint64_t overheadNanos = 0;
+static thread_local uint8_t overheadDepth = 0;
+
+Overhead::Overhead() : _start(overheadDepth++ ? 0 : threadNanos()) {}
+
+Overhead::~Overhead() {
+  if (--overheadDepth == 0) overheadNanos += threadNanos() - _start;
+}
+
+bool Overhead::active() {
+  return overheadDepth != 0;
+}
+
+// -------------------------------------------------------------------
+// ILI9341 PANEL
+// -------------------------------------------------------------------
+
+#define PANEL_WIDTH  240
+#define PANEL_HEIGHT 320
+
+#define CMD_CASET  0x2A
+#define CMD_PASET  0x2B
+#define CMD_RAMWR  0x2C
+#define CMD_MADCTL 0x36
+
+#define MADCTL_MY 0x80
+#define MADCTL_MX 0x40
+#define MADCTL_MV 0x20
+
+static uint16_t frame[PANEL_WIDTH * PANEL_HEIGHT];
+
+static struct {
+  uint8_t command;
+  uint8_t argIndex;
+  uint8_t args[4];
+  uint8_t madctl;
+  bool windowChanged;
+  uint16_t x0, x1, y0, y1; // address window, in the current orientation
+  uint16_t x, y;           // next RAMWR position
+  int16_t pendingByte;     // first half of a pixel, -1 if none
+  int8_t cs, dc;           // pins that select the panel on SPIClass, -1 if unused
+} panel = { 0, 0, { 0 }, 0x48, false, 0, PANEL_WIDTH - 1, 0, PANEL_HEIGHT - 1, 0, 0, -1, -1, -1 };
+
+// Frame buffer index of (x, y) in the orientation MADCTL selects
+static int32_t panelIndex(uint16_t x, uint16_t y) {
+  uint16_t col = x, row = y;
+  if (panel.madctl & MADCTL_MV) {
+    col = y;
+    row = x;
+  }
+  if (col >= PANEL_WIDTH || row >= PANEL_HEIGHT) return -1;
+  if (panel.madctl & MADCTL_MX) col = PANEL_WIDTH - 1 - col;
+  if (panel.madctl & MADCTL_MY) row = PANEL_HEIGHT - 1 - row;
+  return row * PANEL_WIDTH + col;
+}
+
+static void writePixel(uint16_t color) {
+  int32_t i = panelIndex(panel.x, panel.y);
+  if (i >= 0) frame[i] = color;
+  counters.panelPixels++;
+
+  if (++panel.x > panel.x1) {
+    panel.x = panel.x0;
+    if (++panel.y > panel.y1) panel.y = panel.y0;
+  }
+}
+
+void panelAttach(int8_t cs, int8_t dc) {
+  panel.cs = cs;
+  panel.dc = dc;
+}
+
+void spiTransfer(uint8_t b) {
+  Overhead overhead;
+  counters.spiBytes++;
+  if (panel.dc < 0) return;
+  if (panel.cs >= 0 && digitalRead(panel.cs) != LOW) return;
+  if (digitalRead(panel.dc) == LOW) panelCommand(b);
+  else panelData(&b, 1);
+}
+
+void panelCommand(uint8_t cmd) {
+  Overhead overhead;
+  counters.panelCommands++;
+  panel.command = cmd;
+  panel.argIndex = 0;
+  panel.pendingByte = -1;
+
+  if (cmd == CMD_RAMWR) {
+    panel.x = panel.x0;
+    panel.y = panel.y0;
+    if (panel.windowChanged) counters.panelWindows++;
+    panel.windowChanged = false;
+  }
+}
+
+void panelData(const uint8_t* data, size_t len) {
+  Overhead overhead;
+  switch (panel.command) {
+    case CMD_RAMWR:
+      for (size_t i = 0; i < len; i++) {
+        if (panel.pendingByte < 0) {
+          panel.pendingByte = data[i];
+        } else {
+          writePixel((panel.pendingByte << 8) | data[i]);
+          panel.pendingByte = -1;
+        }
+      }
+      break;
+
+    case CMD_CASET:
+    case CMD_PASET:
+      for (size_t i = 0; i < len && panel.argIndex < 4; i++) {
+        panel.args[panel.argIndex++] = data[i];
+      }
+      if (panel.argIndex == 4) {
+        uint16_t start = (panel.args[0] << 8) | panel.args[1];
+        uint16_t end = (panel.args[2] << 8) | panel.args[3];
+        if (panel.command == CMD_CASET) {
+          panel.x0 = start;
+          panel.x1 = end;
+        } else {
+          panel.y0 = start;
+          panel.y1 = end;
+        }
+        panel.windowChanged = true;
+        panel.argIndex++; // ignore anything after the fourth byte
+      }
+      break;
+
+    case CMD_MADCTL:
+      if (len && panel.argIndex == 0) {
+        panel.madctl = data[0];
+        panel.argIndex++;
+      }
+      break;
+
+    default:
+      break;
+  }
+}
+
+int16_t panelWidth() {
+  return (panel.madctl & MADCTL_MV) ? PANEL_HEIGHT : PANEL_WIDTH;
+}
+
+int16_t panelHeight() {
+  return (panel.madctl & MADCTL_MV) ? PANEL_WIDTH : PANEL_HEIGHT;
+}
+
+uint16_t panelPixel(int16_t x, int16_t y) {
+  if (x < 0 || y < 0) return 0;
+  int32_t i = panelIndex(x, y);
+  return i >= 0 ? frame[i] : 0;
+}
+
+bool panelDump(const char* path) {
+  FILE* f = fopen(path, "wb");
+  if (!f) return false;
+
+  int16_t w = panelWidth(), h = panelHeight();
+  fprintf(f, "P6\n%d %d\n255\n", w, h);
+  for (int16_t y = 0; y < h; y++) {
+    for (int16_t x = 0; x < w; x++) {
+      uint16_t c = panelPixel(x, y);
+      uint8_t rgb[3] = {
+        (uint8_t)(((c >> 11) & 0x1F) * 255 / 31),
+        (uint8_t)(((c >> 5) & 0x3F) * 255 / 63),
+        (uint8_t)((c & 0x1F) * 255 / 31)
+      };
+      fwrite(rgb, 1, 3, f);
+    }
+  }
+  return fclose(f) == 0;
+}
+
+// -------------------------------------------------------------------
+// XPT2046 TOUCH CONTROLLER
+// -------------------------------------------------------------------
+
+#define TOUCH_PERIOD_MS 4000
+#define TOUCH_DOWN_MS   3000
+
+bool touchPressed() {
+  return (nowMicros() / 1000) % TOUCH_PERIOD_MS < TOUCH_DOWN_MS;
+}
+
+// 12-bit conversion result for a control byte's channel (A2-A0)
+static uint16_t touchChannel(uint8_t cmd) {
+  uint64_t ms = nowMicros() / 1000;
+  bool down = ms % TOUCH_PERIOD_MS < TOUCH_DOWN_MS;
+  float angle = (float)(ms % TOUCH_DOWN_MS) / TOUCH_DOWN_MS * 2 * (float)M_PI;
+
+  switch ((cmd >> 4) & 0x07) {
+    case 1: return down ? 2048 + (int)(1200 * cosf(angle)) : 0; // X
+    case 5: return down ? 2048 + (int)(1200 * sinf(angle)) : 0; // Y
+    case 3: return down ? 600 : 0;                              // Z1
+    case 4: return down ? 3000 : 4095;                          // Z2
+    default: return 0;
+  }
+}
+
+// A control byte (start bit set) is answered in the 16 clocks after it,
+// MSB first with a leading busy bit: (result << 3) over the next two bytes
+void touchTransfer(const uint8_t* tx, uint8_t* rx, size_t len) {
+  Overhead overhead;
+  if (!rx) return;
+  memset(rx, 0, len);
+  for (size_t i = 0; i < len; i++) {
+    if (!(tx[i] & 0x80)) continue;
+    uint16_t out = touchChannel(tx[i]) << 3;
+    if (i + 1 < len) rx[i + 1] |= out >> 8;
+    if (i + 2 < len) rx[i + 2] |= out & 0xFF;
+  }
+}
+
+// -------------------------------------------------------------------
+// INTERRUPTS
+// -------------------------------------------------------------------
+
+#define MAX_INTERRUPTS 8
+
+struct Interrupt {
+  uint8_t pin;
+  void (*handler)(void*);
+  void* arg;
+  int mode;
+};
+
+static Interrupt interrupts[MAX_INTERRUPTS];
+static uint8_t interruptCount = 0;
+
+void attachInterrupt(uint8_t pin, void (*handler)(void*), void* arg, int mode) {
+  detachInterrupt(pin);
+  if (interruptCount < MAX_INTERRUPTS) interrupts[interruptCount++] = { pin, handler, arg, mode };
+}
+
+void detachInterrupt(uint8_t pin) {
+  for (uint8_t i = 0; i < interruptCount; i++) {
+    if (interrupts[i].pin == pin) {
+      interrupts[i] = interrupts[--interruptCount];
+      return;
+    }
+  }
+}
+
+void tick() {
+  static bool wasPressed = false;
+  bool pressed = touchPressed();
+  if (pressed && !wasPressed) {
+    for (uint8_t i = 0; i < interruptCount; i++) {
+      if (interrupts[i].mode == FALLING || interrupts[i].mode == CHANGE) {
+        interrupts[i].handler(interrupts[i].arg);
+      }
+    }
+  }
+  wasPressed = pressed;
+}
+
+// -------------------------------------------------------------------
+// OTHER CORES
+// -------------------------------------------------------------------
+
+#define MAX_FRAME_HOOKS 4
+
+static void (*frameHooks[MAX_FRAME_HOOKS])();
+static uint8_t frameHookCount = 0;
+
+void atFrameEnd(void (*fn)()) {
+  if (frameHookCount < MAX_FRAME_HOOKS) frameHooks[frameHookCount++] = fn;
+}
+
+void frameEnd() {
+  for (uint8_t i = 0; i < frameHookCount; i++) frameHooks[i]();
+}
+
+// -------------------------------------------------------------------
+// SERIAL
+// -------------------------------------------------------------------
+
+static bool echo = false;
+
+void setSerialEcho(bool on) {
+  echo = on;
+}
+
+bool serialEcho() {
+  return echo;
+}
+
+} // namespace sim
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Shared state of the host simulation: virtual time, the emulated panel,
+// touch controller and I2C parts, and the counters the benchmark reports.
+
+namespace sim {
+
+// --- Time ---
+// millis()/micros() follow the host clock plus every delay() and simulated
+// bus or sensor wait, which advance time without sleeping.
+uint64_t nowMicros();
+void advanceMicros(uint64_t us);
+
+// --- Counters (reset by the benchmark before every loop() call) ---
+struct Counters {
+  uint64_t spiBytes;       // every byte on the display bus, both devices
+  uint32_t spiTransfers;
+  uint32_t panelCommands;  // ILI9341 command bytes
+  uint32_t panelWindows;   // RAMWR after a CASET/PASET pair
+  uint64_t panelPixels;
+  uint64_t i2cBytes;
+  uint64_t serialBytes;
+  uint32_t httpRequests;
+  uint64_t allocations;
+  uint64_t allocatedBytes;
+};
+extern Counters counters;
+void resetCounters();
+
+// CPU time of the calling thread, in nanoseconds
+uint64_t threadNanos();
+
+// CPU time spent inside the simulation itself (panel emulation etc), per
+// thread, so the benchmark can subtract it from the sketch's time. Wrap
+// every stand-in entry point that does emulation work in an Overhead;
+// nested ones are only counted once. Allocations made inside one are not
+// counted either.
+extern thread_local uint64_t overheadNanos;
+
+class Overhead {
+public:
+  Overhead();
+  ~Overhead();
+
+  static bool active();
+
+private:
+  uint64_t _start;
+};
+
+// --- GPIO ---
+// Level most recently set through gpio_set_level(): the panel's D/C line,
+// which TFTDisplay drives from its SPI pre-transfer callback
+int lastGpioLevel();
+
+// --- ILI9341 panel ---
+// Fed by the spi_master stand-in (TFTDisplay) and by SPIClass when the pins
+// registered with panelAttach() select it (Adafruit_ILI9341). Implements
+// CASET, PASET, RAMWR and MADCTL on a 240x320 RGB565 frame buffer.
+void panelAttach(int8_t cs, int8_t dc);
+void spiTransfer(uint8_t b); // one byte from SPIClass
+void panelCommand(uint8_t cmd);
+void panelData(const uint8_t* data, size_t len);
+uint16_t panelPixel(int16_t x, int16_t y); // in the current rotation, RGB565
+int16_t panelWidth();
+int16_t panelHeight();
+bool panelDump(const char* path);          // binary PPM of what the panel shows
+
+// --- XPT2046 touch controller ---
+// Answers a sample burst. The finger follows a scripted path in virtual
+// time: a circle drawn over 3 s, then lifted for 1 s.
+void touchTransfer(const uint8_t* tx, uint8_t* rx, size_t len);
+bool touchPressed();
+
+// --- Interrupts ---
+// Fires FALLING handlers when the scripted finger goes down (XPT2046
+// PENIRQ). The benchmark calls tick() before every loop().
+void attachInterrupt(uint8_t pin, void (*handler)(void*), void* arg, int mode);
+void detachInterrupt(uint8_t pin);
+void tick();
+
+// --- Other cores ---
+// Work that runs beside loop() on the device (the logger's drain task) is
+// registered here and run by the benchmark after each frame, on its thread
+// and outside the frame's CPU time, so what it writes is counted in the
+// frame that produced it every run.
+void atFrameEnd(void (*fn)());
+void frameEnd();
+
+// --- Serial ---
+// Sketch output is counted and discarded unless echoed to stderr
+void setSerialEcho(bool echo);
+bool serialEcho();
+
+} // namespace sim
@@ -0,0 +1,92 @@
+#include "Sim.h"
+
+#include <new>
+#include <stdlib.h>
+
+// Counts every heap allocation the sketch makes: operator new everywhere,
+// and malloc & co. too where the C library lets us wrap them (glibc).
+// Allocations the simulation makes inside a sim::Overhead scope are not
+// counted.
+
+static inline void count(size_t size) {
+  if (sim::Overhead::active()) return;
+  __atomic_fetch_add(&sim::counters.allocations, 1, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&sim::counters.allocatedBytes, size, __ATOMIC_RELAXED);
+}
+
+#if defined(__GLIBC__)
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t n, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void __libc_free(void* ptr);
+
+void* malloc(size_t size) {
+  count(size);
+  return __libc_malloc(size);
+}
+
+void* calloc(size_t n, size_t size) {
+  count(n * size);
+  return __libc_calloc(n, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+  count(size);
+  return __libc_realloc(ptr, size);
+}
+
+void free(void* ptr) {
+  __libc_free(ptr);
+}
+}
+
+#define rawMalloc __libc_malloc
+#else
+#define rawMalloc malloc
+#endif
+
+static void* allocate(size_t size) {
+  void* p = rawMalloc(size ? size : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+
+void* operator new(size_t size) {
+  count(size);
+  return allocate(size);
+}
+
+void* operator new[](size_t size) {
+  count(size);
+  return allocate(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  count(size);
+  try {
+    return allocate(size);
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+  return operator new(size, std::nothrow);
+}
+
+void operator delete(void* ptr) noexcept {
+  free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+  free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+  free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept {
+  free(ptr);
+}
@@ -0,0 +1,285 @@
+// Benchmark driver: runs the sketch's setup() once and loop() for a fixed
+// number of frames against the simulated hardware, and reports per-frame
+// CPU time, bus traffic and heap allocations.
+//
+//   program [--frames N] [--warmup N] [--name NAME] [--csv FILE]
+//           [--save FILE] [--baseline FILE] [--tolerance PCT]
+//           [--pace MS] [--dump FILE.ppm] [--serial]
+//
+// CPU time is the main thread's, minus the time spent inside the
+// simulation itself (sim::Overhead). --save writes the summary in the form
+// --baseline reads back; with --baseline the exit status is 1 if any metric
+// regressed by more than --tolerance percent (default 15).
+//
+// Sketches whose loop() never waits would otherwise see no time pass
+// between frames (touch scripts, clocks and timeouts would never move), so
+// each frame takes at least --pace milliseconds of virtual time (default 10).
+//
+// `pio test -e native` builds the stand-ins without this file's main(): the
+// test runner brings its own.
+
+#ifndef PIO_UNIT_TESTING
+
+#include "Arduino.h"
+#include "Sim.h"
+
+#include <algorithm>
+#include <map>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+struct Metric {
+  const char* name;
+  const char* unit;
+  bool compare; // checked against the baseline
+};
+
+// Column order of Sample::values
+const Metric metrics[] = {
+  { "cpu",            "us",    true  },
+  { "spi_bytes",      "B",     true  },
+  { "spi_transfers",  "",      true  },
+  { "panel_windows",  "",      true  },
+  { "panel_pixels",   "",      true  },
+  { "panel_commands", "",      true  },
+  { "i2c_bytes",      "B",     true  },
+  { "allocations",    "",      true  },
+  { "alloc_bytes",    "B",     true  },
+  { "serial_bytes",   "B",     false }, // telemetry records carry timings
+  { "http_requests",  "",      false },
+  { "sim_time",       "ms",    false },
+};
+const size_t METRIC_COUNT = sizeof(metrics) / sizeof(metrics[0]);
+
+struct Sample {
+  double values[METRIC_COUNT];
+};
+
+struct Stats {
+  double mean, p50, p99, max;
+};
+
+struct Options {
+  int frames = 300;
+  int warmup = 10;
+  std::string name = "sketch";
+  const char* csv = nullptr;
+  const char* save = nullptr;
+  const char* baseline = nullptr;
+  double tolerance = 15;
+  int pace = 10;
+  const char* dump = nullptr;
+};
+
+void usage(const char* argv0) {
+  fprintf(stderr,
+          "usage: %s [--frames N] [--warmup N] [--name NAME] [--csv FILE] [--save FILE]\n"
+          "          [--baseline FILE] [--tolerance PCT] [--pace MS] [--dump FILE.ppm] [--serial]\n",
+          argv0);
+  exit(2);
+}
+
+Options parseArgs(int argc, char** argv) {
+  Options opt;
+  for (int i = 1; i < argc; i++) {
+    const char* arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (!strcmp(arg, "--serial")) {
+      sim::setSerialEcho(true);
+    } else if (!hasValue) {
+      usage(argv[0]);
+    } else if (!strcmp(arg, "--frames")) {
+      opt.frames = atoi(argv[++i]);
+    } else if (!strcmp(arg, "--warmup")) {
+      opt.warmup = atoi(argv[++i]);
+    } else if (!strcmp(arg, "--name")) {
+      opt.name = argv[++i];
+    } else if (!strcmp(arg, "--csv")) {
+      opt.csv = argv[++i];
+    } else if (!strcmp(arg, "--save")) {
+      opt.save = argv[++i];
+    } else if (!strcmp(arg, "--baseline")) {
+      opt.baseline = argv[++i];
+    } else if (!strcmp(arg, "--tolerance")) {
+      opt.tolerance = atof(argv[++i]);
+    } else if (!strcmp(arg, "--pace")) {
+      opt.pace = atoi(argv[++i]);
+    } else if (!strcmp(arg, "--dump")) {
+      opt.dump = argv[++i];
+    } else {
+      usage(argv[0]);
+    }
+  }
+  if (opt.frames < 1) opt.frames = 1;
+  if (opt.warmup < 0) opt.warmup = 0;
+  if (opt.pace < 0) opt.pace = 0;
+  return opt;
+}
+
+// Runs fn once and records what it cost
+template <typename Fn>
+Sample measure(Fn fn) {
+  sim::resetCounters();
+  uint64_t simStart = sim::nowMicros();
+  uint64_t overheadStart = sim::overheadNanos;
+  uint64_t cpuStart = sim::threadNanos();
+
+  fn();
+
+  uint64_t cpu = sim::threadNanos() - cpuStart - (sim::overheadNanos - overheadStart);
+  sim::frameEnd(); // other cores' work: counted, but not as this thread's CPU
+
+  const sim::Counters& c = sim::counters;
+  Sample s = { {
+    cpu / 1000.0,
+    (double)c.spiBytes,
+    (double)c.spiTransfers,
+    (double)c.panelWindows,
+    (double)c.panelPixels,
+    (double)c.panelCommands,
+    (double)c.i2cBytes,
+    (double)c.allocations,
+    (double)c.allocatedBytes,
+    (double)c.serialBytes,
+    (double)c.httpRequests,
+    (sim::nowMicros() - simStart) / 1000.0,
+  } };
+  return s;
+}
+
+Stats statsOf(const std::vector<Sample>& samples, size_t metric) {
+  std::vector<double> v;
+  v.reserve(samples.size());
+  double sum = 0;
+  for (const Sample& s : samples) {
+    v.push_back(s.values[metric]);
+    sum += s.values[metric];
+  }
+  std::sort(v.begin(), v.end());
+  auto at = [&](double q) { return v[std::min(v.size() - 1, (size_t)(q * (v.size() - 1) + 0.5))]; };
+  return { sum / v.size(), at(0.5), at(0.99), v.back() };
+}
+
+void printRow(FILE* out, const char* label, const char* unit, const Stats& s) {
+  char name[32];
+  snprintf(name, sizeof(name), "%s%s%s", label, *unit ? " " : "", unit);
+  fprintf(out, "  %-18s %12.1f %12.1f %12.1f %12.1f\n", name, s.mean, s.p50, s.p99, s.max);
+}
+
+// Baseline files hold one "metric mean p50 p99 max" line per metric
+std::map<std::string, Stats> loadBaseline(const char* path) {
+  std::map<std::string, Stats> baseline;
+  FILE* f = fopen(path, "r");
+  if (!f) {
+    fprintf(stderr, "cannot open baseline %s\n", path);
+    exit(2);
+  }
+  char name[64];
+  Stats s;
+  while (fscanf(f, "%63s %lf %lf %lf %lf", name, &s.mean, &s.p50, &s.p99, &s.max) == 5) baseline[name] = s;
+  fclose(f);
+  return baseline;
+}
+
+// CPU time is judged on the median (robust to scheduler noise), counters on
+// the mean
+int compareBaseline(const char* path, const Stats* current, double tolerance) {
+  std::map<std::string, Stats> baseline = loadBaseline(path);
+  int regressions = 0;
+
+  printf("\n  vs %s (tolerance %.0f%%)\n", path, tolerance);
+  for (size_t m = 0; m < METRIC_COUNT; m++) {
+    if (!metrics[m].compare) continue;
+    auto it = baseline.find(metrics[m].name);
+    if (it == baseline.end()) continue;
+
+    bool useMedian = m == 0;
+    double before = useMedian ? it->second.p50 : it->second.mean;
+    double now = useMedian ? current[m].p50 : current[m].mean;
+    double change = before > 0 ? (now - before) * 100 / before : (now > 0 ? 100 : 0);
+    bool regressed = change > tolerance;
+    if (regressed) regressions++;
+    printf("  %-18s %12.1f -> %12.1f  %+7.1f%%%s\n", metrics[m].name, before, now, change,
+           regressed ? "  REGRESSION" : "");
+  }
+  return regressions;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  Options opt = parseArgs(argc, argv);
+
+  Sample setupCost = measure([] { setup(); });
+
+  std::vector<Sample> samples;
+  samples.reserve(opt.frames);
+  for (int i = 0; i < opt.warmup + opt.frames; i++) {
+    uint64_t frameStart = sim::nowMicros();
+    sim::tick();
+    if (i < opt.warmup) loop();
+    else samples.push_back(measure([] { loop(); }));
+
+    uint64_t elapsed = sim::nowMicros() - frameStart;
+    uint64_t period = (uint64_t)opt.pace * 1000;
+    if (elapsed < period) sim::advanceMicros(period - elapsed);
+  }
+
+  Stats stats[METRIC_COUNT];
+  for (size_t m = 0; m < METRIC_COUNT; m++) stats[m] = statsOf(samples, m);
+
+  printf("%s: setup %.1f ms CPU, %.0f SPI bytes, %.0f allocations\n", opt.name.c_str(),
+         setupCost.values[0] / 1000, setupCost.values[1], setupCost.values[7]);
+  printf("%s: %d frames after %d warm-up, per frame:\n", opt.name.c_str(), opt.frames, opt.warmup);
+  printf("  %-18s %12s %12s %12s %12s\n", "", "mean", "p50", "p99", "max");
+  for (size_t m = 0; m < METRIC_COUNT; m++) printRow(stdout, metrics[m].name, metrics[m].unit, stats[m]);
+
+  if (opt.csv) {
+    FILE* f = fopen(opt.csv, "w");
+    if (!f) {
+      fprintf(stderr, "cannot write %s\n", opt.csv);
+    } else {
+      fprintf(f, "frame");
+      for (size_t m = 0; m < METRIC_COUNT; m++) fprintf(f, ",%s", metrics[m].name);
+      fprintf(f, "\n");
+      for (size_t i = 0; i < samples.size(); i++) {
+        fprintf(f, "%zu", i);
+        for (size_t m = 0; m < METRIC_COUNT; m++) fprintf(f, ",%.3f", samples[i].values[m]);
+        fprintf(f, "\n");
+      }
+      fclose(f);
+    }
+  }
+
+  if (opt.save) {
+    FILE* f = fopen(opt.save, "w");
+    if (!f) {
+      fprintf(stderr, "cannot write %s\n", opt.save);
+    } else {
+      for (size_t m = 0; m < METRIC_COUNT; m++) {
+        fprintf(f, "%s %.3f %.3f %.3f %.3f\n", metrics[m].name, stats[m].mean, stats[m].p50, stats[m].p99,
+                stats[m].max);
+      }
+      fclose(f);
+    }
+  }
+
+  if (opt.dump && !sim::panelDump(opt.dump)) fprintf(stderr, "cannot write %s\n", opt.dump);
+
+  int status = 0;
+  if (opt.baseline && compareBaseline(opt.baseline, stats, opt.tolerance)) status = 1;
+
+  // Background threads (the logger's drain) may still be running: leave
+  // without static destructors
+  fflush(stdout);
+  fflush(stderr);
+  _exit(status);
+}
+
+#endif // PIO_UNIT_TESTING
@@ -0,0 +1,106 @@
+#include "Stream.h"
+#include "Arduino.h"
+
+// Nothing on the host delivers bytes while the sketch waits (simulated
+// devices answer before requestFrom() returns), so waiting out _timeout
+// would only burn real time: give up as soon as the buffer is empty
+int Stream::timedRead() {
+  return read();
+}
+
+int Stream::timedPeek() {
+  return peek();
+}
+
+int Stream::peekNextDigit(bool allowDecimal) {
+  for (;;) {
+    int c = timedPeek();
+    if (c < 0 || c == '-' || (c >= '0' && c <= '9') || (allowDecimal && c == '.')) return c;
+    read();
+  }
+}
+
+bool Stream::find(const char* target) {
+  return find(target, strlen(target));
+}
+
+bool Stream::find(const char* target, size_t length) {
+  if (length == 0) return true;
+  size_t matched = 0;
+  int c;
+  while ((c = timedRead()) >= 0) {
+    if (c == target[matched]) {
+      if (++matched == length) return true;
+    } else {
+      matched = (c == target[0]) ? 1 : 0;
+    }
+  }
+  return false;
+}
+
+long Stream::parseInt() {
+  int c = peekNextDigit(false);
+  if (c < 0) return 0;
+  bool negative = false;
+  long value = 0;
+  do {
+    if (c == '-') negative = true;
+    else value = value * 10 + c - '0';
+    read();
+    c = timedPeek();
+  } while (c >= '0' && c <= '9');
+  return negative ? -value : value;
+}
+
+float Stream::parseFloat() {
+  int c = peekNextDigit(true);
+  if (c < 0) return 0;
+  bool negative = false, fraction = false;
+  double value = 0, scale = 1;
+  do {
+    if (c == '-') negative = true;
+    else if (c == '.') fraction = true;
+    else {
+      value = value * 10 + c - '0';
+      if (fraction) scale *= 0.1;
+    }
+    read();
+    c = timedPeek();
+  } while ((c >= '0' && c <= '9') || (c == '.' && !fraction));
+  value *= scale;
+  return negative ? -value : value;
+}
+
+size_t Stream::readBytes(char* buffer, size_t length) {
+  size_t n = 0;
+  while (n < length) {
+    int c = timedRead();
+    if (c < 0) break;
+    buffer[n++] = (char)c;
+  }
+  return n;
+}
+
+size_t Stream::readBytesUntil(char terminator, char* buffer, size_t length) {
+  size_t n = 0;
+  while (n < length) {
+    int c = timedRead();
+    if (c < 0 || c == terminator) break;
+    buffer[n++] = (char)c;
+  }
+  return n;
+}
+
+String Stream::readString() {
+  String s;
+  int c;
+  while ((c = timedRead()) >= 0) s += (char)c;
+  return s;
+}
+
+String Stream::readStringUntil(char terminator) {
+  String s;
+  int c;
+  while ((c = timedRead()) >= 0 && c != terminator) s += (char)c;
+  return s;
+}
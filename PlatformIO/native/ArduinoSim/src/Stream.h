@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Print.h"
+
+class Stream : public Print {
+public:
+  Stream() : _timeout(1000) {}
+
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+
+  void setTimeout(unsigned long timeout) { _timeout = timeout; }
+  unsigned long getTimeout() const { return _timeout; }
+
+  bool find(const char* target);
+  bool find(char target) { return find(&target, 1); }
+  bool find(const char* target, size_t length);
+
+  long parseInt();
+  float parseFloat();
+
+  virtual size_t readBytes(char* buffer, size_t length);
+  size_t readBytes(uint8_t* buffer, size_t length) { return readBytes((char*)buffer, length); }
+  size_t readBytesUntil(char terminator, char* buffer, size_t length);
+  String readString();
+  String readStringUntil(char terminator);
+
+protected:
+  int timedRead();
+  int timedPeek();
+  int peekNextDigit(bool allowDecimal);
+
+  unsigned long _timeout;
+};
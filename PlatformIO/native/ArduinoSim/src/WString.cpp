@@ -0,0 +1,320 @@
+#include "WString.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+String::String(const char* cstr) {
+  init();
+  if (cstr) assign(cstr, strlen(cstr));
+}
+
+String::String(const char* cstr, size_t length) {
+  init();
+  if (cstr) assign(cstr, length);
+}
+
+String::String(const String& str) {
+  init();
+  assign(str.c_str(), str._len);
+}
+
+String::String(String&& str) {
+  init();
+  take(str);
+}
+
+// Steals str's heap buffer, or copies its inline one
+void String::take(String& str) {
+  if (str.isSSO()) {
+    assign(str._buffer, str._len);
+  } else {
+    release();
+    _buffer = str._buffer;
+    _capacity = str._capacity;
+    _len = str._len;
+    str.init();
+  }
+  str._len = 0;
+  str._buffer[0] = '\0';
+}
+
+String::String(const __FlashStringHelper* str) : String(reinterpret_cast<const char*>(str)) {}
+
+String::String(char c) {
+  init();
+  assign(&c, 1);
+}
+
+static void formatInteger(char* buf, unsigned long long value, bool negative, unsigned char base) {
+  char tmp[72];
+  char* p = tmp + sizeof(tmp) - 1;
+  *p = '\0';
+  if (base < 2) base = 10;
+  do {
+    unsigned digit = value % base;
+    *--p = digit < 10 ? '0' + digit : 'a' + digit - 10;
+    value /= base;
+  } while (value);
+  if (negative) *--p = '-';
+  strcpy(buf, p);
+}
+
+#define STRING_FROM_SIGNED(type)                                                  \
+  String::String(type value, unsigned char base) {                                \
+    init();                                                                       \
+    char buf[72];                                                                 \
+    bool negative = value < 0 && base == 10;                                      \
+    unsigned long long magnitude = negative ? 0ULL - (unsigned long long)value    \
+                                            : (unsigned long long)value;          \
+    if (!negative && value < 0) magnitude &= (~0ULL >> (64 - 8 * sizeof(type)));  \
+    formatInteger(buf, magnitude, negative, base);                                \
+    assign(buf, strlen(buf));                                                     \
+  }
+
+#define STRING_FROM_UNSIGNED(type)                                                \
+  String::String(type value, unsigned char base) {                                \
+    init();                                                                       \
+    char buf[72];                                                                 \
+    formatInteger(buf, value, false, base);                                       \
+    assign(buf, strlen(buf));                                                     \
+  }
+
+STRING_FROM_UNSIGNED(unsigned char)
+STRING_FROM_SIGNED(int)
+STRING_FROM_UNSIGNED(unsigned int)
+STRING_FROM_SIGNED(long)
+STRING_FROM_UNSIGNED(unsigned long)
+STRING_FROM_SIGNED(long long)
+STRING_FROM_UNSIGNED(unsigned long long)
+
+String::String(float value, unsigned int decimals) : String((double)value, decimals) {}
+
+String::String(double value, unsigned int decimals) {
+  init();
+  char buf[64];
+  snprintf(buf, sizeof(buf), "%.*f", (int)decimals, value);
+  assign(buf, strlen(buf));
+}
+
+String::~String() {
+  release();
+}
+
+void String::release() {
+  if (!isSSO()) free(_buffer);
+  init();
+}
+
+String& String::operator=(const String& rhs) {
+  if (this != &rhs) assign(rhs.c_str(), rhs._len);
+  return *this;
+}
+
+String& String::operator=(String&& rhs) {
+  if (this != &rhs) take(rhs);
+  return *this;
+}
+
+String& String::operator=(const char* cstr) {
+  if (cstr) assign(cstr, strlen(cstr));
+  else release();
+  return *this;
+}
+
+String& String::operator=(const __FlashStringHelper* str) {
+  return *this = reinterpret_cast<const char*>(str);
+}
+
+bool String::reserve(size_t size) {
+  if (_capacity >= size) return true;
+  char* grown;
+  if (isSSO()) {
+    grown = (char*)malloc(size + 1);
+    if (grown) memcpy(grown, _sso, _len + 1);
+  } else {
+    grown = (char*)realloc(_buffer, size + 1);
+  }
+  if (!grown) return false;
+  _buffer = grown;
+  _capacity = size;
+  return true;
+}
+
+bool String::assign(const char* cstr, size_t length) {
+  if (!reserve(length)) {
+    release();
+    return false;
+  }
+  memmove(_buffer, cstr, length);
+  _buffer[length] = '\0';
+  _len = length;
+  return true;
+}
+
+bool String::concat(const char* cstr) {
+  return cstr && concat(cstr, strlen(cstr));
+}
+
+bool String::concat(const char* cstr, size_t length) {
+  if (!cstr) return false;
+  if (length == 0) return true;
+  // cstr may point into our own buffer
+  size_t offset = (cstr >= _buffer && cstr < _buffer + _len) ? cstr - _buffer : (size_t)-1;
+  if (!reserve(_len + length)) return false;
+  if (offset != (size_t)-1) cstr = _buffer + offset;
+  memmove(_buffer + _len, cstr, length);
+  _len += length;
+  _buffer[_len] = '\0';
+  return true;
+}
+
+int String::compareTo(const String& s) const {
+  return strcmp(c_str(), s.c_str());
+}
+
+bool String::equals(const String& s) const {
+  return _len == s._len && compareTo(s) == 0;
+}
+
+bool String::equals(const char* cstr) const {
+  return strcmp(c_str(), cstr ? cstr : "") == 0;
+}
+
+bool String::equalsIgnoreCase(const String& s) const {
+  if (_len != s._len) return false;
+  for (size_t i = 0; i < _len; i++) {
+    if (tolower((unsigned char)_buffer[i]) != tolower((unsigned char)s._buffer[i])) return false;
+  }
+  return true;
+}
+
+bool String::startsWith(const String& prefix) const {
+  return prefix._len <= _len && strncmp(c_str(), prefix.c_str(), prefix._len) == 0;
+}
+
+bool String::endsWith(const String& suffix) const {
+  return suffix._len <= _len && strcmp(c_str() + _len - suffix._len, suffix.c_str()) == 0;
+}
+
+char& String::operator[](size_t index) {
+  static char dummy;
+  if (index >= _len) {
+    dummy = 0;
+    return dummy;
+  }
+  return _buffer[index];
+}
+
+int String::indexOf(char ch, size_t from) const {
+  if (from >= _len) return -1;
+  const char* p = strchr(c_str() + from, ch);
+  return p ? p - c_str() : -1;
+}
+
+int String::indexOf(const String& str, size_t from) const {
+  if (from >= _len) return -1;
+  const char* p = strstr(c_str() + from, str.c_str());
+  return p ? p - c_str() : -1;
+}
+
+int String::lastIndexOf(char ch) const {
+  const char* p = strrchr(c_str(), ch);
+  return p ? p - c_str() : -1;
+}
+
+String String::substring(size_t from, size_t to) const {
+  if (from > to) {
+    size_t t = from;
+    from = to;
+    to = t;
+  }
+  if (from >= _len) return String();
+  if (to > _len) to = _len;
+  return String(c_str() + from, to - from);
+}
+
+void String::replace(char find, char replace) {
+  for (size_t i = 0; i < _len; i++) {
+    if (_buffer[i] == find) _buffer[i] = replace;
+  }
+}
+
+void String::replace(const String& find, const String& replace) {
+  if (find._len == 0) return;
+  String out;
+  size_t i = 0;
+  while (i < _len) {
+    const char* hit = strstr(c_str() + i, find.c_str());
+    if (!hit) break;
+    size_t at = hit - c_str();
+    out.concat(c_str() + i, at - i);
+    out.concat(replace);
+    i = at + find._len;
+  }
+  out.concat(c_str() + i, _len - i);
+  *this = static_cast<String&&>(out);
+}
+
+void String::remove(size_t index, size_t count) {
+  if (index >= _len) return;
+  if (count > _len - index) count = _len - index;
+  memmove(_buffer + index, _buffer + index + count, _len - index - count + 1);
+  _len -= count;
+}
+
+void String::toLowerCase() {
+  for (size_t i = 0; i < _len; i++) _buffer[i] = tolower((unsigned char)_buffer[i]);
+}
+
+void String::toUpperCase() {
+  for (size_t i = 0; i < _len; i++) _buffer[i] = toupper((unsigned char)_buffer[i]);
+}
+
+void String::trim() {
+  if (!_len) return;
+  size_t begin = 0;
+  while (begin < _len && isspace((unsigned char)_buffer[begin])) begin++;
+  size_t end = _len;
+  while (end > begin && isspace((unsigned char)_buffer[end - 1])) end--;
+  _len = end - begin;
+  memmove(_buffer, _buffer + begin, _len);
+  _buffer[_len] = '\0';
+}
+
+long String::toInt() const {
+  return atol(c_str());
+}
+
+float String::toFloat() const {
+  return (float)atof(c_str());
+}
+
+double String::toDouble() const {
+  return atof(c_str());
+}
+
+String operator+(const String& lhs, const String& rhs) {
+  String s(lhs);
+  s.concat(rhs);
+  return s;
+}
+
+String operator+(const String& lhs, const char* rhs) {
+  String s(lhs);
+  s.concat(rhs);
+  return s;
+}
+
+String operator+(const char* lhs, const String& rhs) {
+  String s(lhs);
+  s.concat(rhs);
+  return s;
+}
+
+String operator+(const String& lhs, char rhs) {
+  String s(lhs);
+  s.concat(rhs);
+  return s;
+}
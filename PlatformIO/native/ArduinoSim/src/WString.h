@@ -0,0 +1,117 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "pgmspace.h"
+
+// Arduino String on the C heap (so its allocations show up in the
+// benchmark's counts), with the ESP32 core's small-string buffer: up to
+// 11 characters live inside the object and never allocate
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper*>(PSTR(s)))
+
+class String {
+public:
+  String(const char* cstr = "");
+  String(const char* cstr, size_t length);
+  String(const String& str);
+  String(String&& str);
+  String(const __FlashStringHelper* str);
+  explicit String(char c);
+  explicit String(unsigned char value, unsigned char base = 10);
+  explicit String(int value, unsigned char base = 10);
+  explicit String(unsigned int value, unsigned char base = 10);
+  explicit String(long value, unsigned char base = 10);
+  explicit String(unsigned long value, unsigned char base = 10);
+  explicit String(long long value, unsigned char base = 10);
+  explicit String(unsigned long long value, unsigned char base = 10);
+  explicit String(float value, unsigned int decimals = 2);
+  explicit String(double value, unsigned int decimals = 2);
+  ~String();
+
+  String& operator=(const String& rhs);
+  String& operator=(String&& rhs);
+  String& operator=(const char* cstr);
+  String& operator=(const __FlashStringHelper* str);
+
+  bool reserve(size_t size);
+  size_t length() const { return _len; }
+  bool isEmpty() const { return _len == 0; }
+  const char* c_str() const { return _buffer; }
+
+  bool concat(const String& str) { return concat(str.c_str(), str._len); }
+  bool concat(const char* cstr);
+  bool concat(const char* cstr, size_t length);
+  bool concat(const __FlashStringHelper* str) { return concat(reinterpret_cast<const char*>(str)); }
+  bool concat(char c) { return concat(&c, 1); }
+  bool concat(unsigned char value) { return concat(String(value)); }
+  bool concat(int value) { return concat(String(value)); }
+  bool concat(unsigned int value) { return concat(String(value)); }
+  bool concat(long value) { return concat(String(value)); }
+  bool concat(unsigned long value) { return concat(String(value)); }
+  bool concat(long long value) { return concat(String(value)); }
+  bool concat(unsigned long long value) { return concat(String(value)); }
+  bool concat(float value) { return concat(String(value)); }
+  bool concat(double value) { return concat(String(value)); }
+
+  template <typename T>
+  String& operator+=(const T& rhs) {
+    concat(rhs);
+    return *this;
+  }
+
+  int compareTo(const String& s) const;
+  bool equals(const String& s) const;
+  bool equals(const char* cstr) const;
+  bool equalsIgnoreCase(const String& s) const;
+  bool operator==(const String& rhs) const { return equals(rhs); }
+  bool operator==(const char* cstr) const { return equals(cstr); }
+  bool operator!=(const String& rhs) const { return !equals(rhs); }
+  bool operator!=(const char* cstr) const { return !equals(cstr); }
+  bool operator<(const String& rhs) const { return compareTo(rhs) < 0; }
+
+  bool startsWith(const String& prefix) const;
+  bool endsWith(const String& suffix) const;
+
+  char charAt(size_t index) const { return index < _len ? _buffer[index] : 0; }
+  void setCharAt(size_t index, char c) { if (index < _len) _buffer[index] = c; }
+  char operator[](size_t index) const { return charAt(index); }
+  char& operator[](size_t index);
+
+  int indexOf(char ch, size_t from = 0) const;
+  int indexOf(const String& str, size_t from = 0) const;
+  int lastIndexOf(char ch) const;
+  String substring(size_t from) const { return substring(from, _len); }
+  String substring(size_t from, size_t to) const;
+
+  void replace(char find, char replace);
+  void replace(const String& find, const String& replace);
+  void remove(size_t index, size_t count = (size_t)-1);
+  void toLowerCase();
+  void toUpperCase();
+  void trim();
+
+  long toInt() const;
+  float toFloat() const;
+  double toDouble() const;
+
+private:
+  enum { SSO_CAPACITY = 11 };
+
+  bool assign(const char* cstr, size_t length);
+  void release();
+  bool isSSO() const { return _buffer == _sso; }
+  void init() { _buffer = _sso; _sso[0] = '\0'; _capacity = SSO_CAPACITY; _len = 0; }
+  void take(String& str);
+
+  char* _buffer;
+  size_t _capacity;
+  size_t _len;
+  char _sso[SSO_CAPACITY + 1];
+};
+
+String operator+(const String& lhs, const String& rhs);
+String operator+(const String& lhs, const char* rhs);
+String operator+(const char* lhs, const String& rhs);
+String operator+(const String& lhs, char rhs);
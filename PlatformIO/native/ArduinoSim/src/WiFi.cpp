@@ -0,0 +1,67 @@
+#include "WiFi.h"
+#include "Sim.h"
+
+WiFiClass WiFi;
+
+// 2024-06-01 12:00:00 UTC in NTP seconds (since 1900)
+#define NTP_EPOCH_START 3926232000UL
+
+WiFiUDP::WiFiUDP() : _txPort(0), _txLength(0), _pending(false), _rxLength(0), _rxIndex(0) {}
+
+int WiFiUDP::beginPacket(IPAddress ip, uint16_t port) {
+  _txPort = port;
+  _txLength = 0;
+  return 1;
+}
+
+int WiFiUDP::beginPacket(const char* host, uint16_t port) {
+  return beginPacket(IPAddress(), port);
+}
+
+size_t WiFiUDP::write(uint8_t data) {
+  _txLength++;
+  return 1;
+}
+
+size_t WiFiUDP::write(const uint8_t* buffer, size_t size) {
+  _txLength += size;
+  return size;
+}
+
+int WiFiUDP::endPacket() {
+  if (_txPort == 123 && _txLength >= NTP_PACKET_LENGTH) {
+    // A round trip on a decent link
+    sim::advanceMicros(20000);
+
+    uint32_t seconds = NTP_EPOCH_START + (uint32_t)(sim::nowMicros() / 1000000);
+    memset(_rxBuffer, 0, sizeof(_rxBuffer));
+    _rxBuffer[0] = 0x24; // no leap warning, version 4, server
+    _rxBuffer[1] = 2;    // stratum
+    for (int i = 0; i < 4; i++) {
+      uint8_t b = seconds >> (24 - 8 * i);
+      _rxBuffer[32 + i] = b; // receive timestamp
+      _rxBuffer[40 + i] = b; // transmit timestamp
+    }
+    _pending = true;
+  }
+  _txLength = 0;
+  return 1;
+}
+
+int WiFiUDP::parsePacket() {
+  if (!_pending) return 0;
+  _pending = false;
+  _rxLength = NTP_PACKET_LENGTH;
+  _rxIndex = 0;
+  return _rxLength;
+}
+
+int WiFiUDP::read(unsigned char* buffer, size_t len) {
+  size_t n = 0;
+  while (n < len && _rxIndex < _rxLength) buffer[n++] = _rxBuffer[_rxIndex++];
+  return n;
+}
+
+void WiFiUDP::flush() {
+  _rxLength = _rxIndex = 0;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Arduino.h"
+#include "WiFiUdp.h"
+
+// Station that associates immediately and stays connected
+
+typedef enum {
+  WL_NO_SHIELD = 255,
+  WL_IDLE_STATUS = 0,
+  WL_NO_SSID_AVAIL = 1,
+  WL_SCAN_COMPLETED = 2,
+  WL_CONNECTED = 3,
+  WL_CONNECT_FAILED = 4,
+  WL_CONNECTION_LOST = 5,
+  WL_DISCONNECTED = 6
+} wl_status_t;
+
+typedef enum {
+  WIFI_OFF = 0,
+  WIFI_STA = 1,
+  WIFI_AP = 2,
+  WIFI_AP_STA = 3
+} wifi_mode_t;
+
+class WiFiClass {
+public:
+  WiFiClass() : _status(WL_IDLE_STATUS) {}
+
+  wl_status_t begin(const char* ssid, const char* passphrase = nullptr) {
+    _status = WL_CONNECTED;
+    return _status;
+  }
+  bool disconnect(bool wifiOff = false) {
+    _status = WL_DISCONNECTED;
+    return true;
+  }
+  bool reconnect() {
+    _status = WL_CONNECTED;
+    return true;
+  }
+  wl_status_t status() const { return _status; }
+  bool isConnected() const { return _status == WL_CONNECTED; }
+  bool mode(wifi_mode_t m) { return true; }
+  bool setSleep(bool enabled) { return true; }
+  bool setHostname(const char* name) { return true; }
+
+  IPAddress localIP() const { return IPAddress(192, 168, 4, 2); }
+  IPAddress gatewayIP() const { return IPAddress(192, 168, 4, 1); }
+  int8_t RSSI() const { return -58; }
+  String SSID() const { return String("simulated"); }
+  String macAddress() const { return String("02:00:00:00:00:01"); }
+
+private:
+  wl_status_t _status;
+};
+
+extern WiFiClass WiFi;
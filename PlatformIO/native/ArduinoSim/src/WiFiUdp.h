@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Udp.h"
+
+#define NTP_PACKET_LENGTH 48
+
+// Packets sent to port 123 are answered by a simulated NTP server whose
+// clock starts at 2024-06-01 12:00:00 UTC and follows virtual time.
+// Everything else is dropped.
+class WiFiUDP : public UDP {
+public:
+  WiFiUDP();
+
+  uint8_t begin(uint16_t port) override { return 1; }
+  void stop() override {}
+
+  int beginPacket(IPAddress ip, uint16_t port) override;
+  int beginPacket(const char* host, uint16_t port) override;
+  int endPacket() override;
+  size_t write(uint8_t data) override;
+  size_t write(const uint8_t* buffer, size_t size) override;
+  using Print::write;
+
+  int parsePacket() override;
+  int available() override { return _rxLength - _rxIndex; }
+  int read() override { return _rxIndex < _rxLength ? _rxBuffer[_rxIndex++] : -1; }
+  int read(unsigned char* buffer, size_t len) override;
+  int read(char* buffer, size_t len) override { return read((unsigned char*)buffer, len); }
+  int peek() override { return _rxIndex < _rxLength ? _rxBuffer[_rxIndex] : -1; }
+  void flush() override;
+
+  IPAddress remoteIP() override { return IPAddress(162, 159, 200, 1); }
+  uint16_t remotePort() override { return 123; }
+
+private:
+  uint16_t _txPort;
+  size_t _txLength;
+  bool _pending; // reply queued, not yet picked up by parsePacket()
+  uint8_t _rxBuffer[NTP_PACKET_LENGTH];
+  size_t _rxLength;
+  size_t _rxIndex;
+};
@@ -0,0 +1,167 @@
+#include "Wire.h"
+#include "Sim.h"
+
+TwoWire Wire;
+
+// -------------------------------------------------------------------
+// SIMULATED PARTS
+// -------------------------------------------------------------------
+
+// Word-addressed memory map, big-endian words
+class MLX90640Sim : public I2CSimDevice {
+public:
+  MLX90640Sim() : _pointer(0), _control(0x1901) {
+    // Deterministic EEPROM contents; the device ID (0x2407-0x2409) must not
+    // read as blank
+    uint32_t seed = 0x90640;
+    for (int i = 0; i < EEPROM_WORDS; i++) {
+      seed = seed * 1664525u + 1013904223u;
+      _eeprom[i] = seed >> 16;
+    }
+    _eeprom[0x07] = 0x1A2B;
+    _eeprom[0x08] = 0x3C4D;
+    _eeprom[0x09] = 0x5E6F;
+  }
+
+  void write(const uint8_t* data, size_t len) override {
+    if (len >= 2) _pointer = (data[0] << 8) | data[1];
+    if (len >= 4 && _pointer == 0x800D) _control = (data[2] << 8) | data[3];
+  }
+
+  void read(uint8_t* data, size_t len) override {
+    for (size_t i = 0; i + 1 < len; i += 2) {
+      uint16_t word = wordAt(_pointer++);
+      data[i] = word >> 8;
+      data[i + 1] = word & 0xFF;
+    }
+  }
+
+private:
+  enum { EEPROM_BASE = 0x2400, EEPROM_WORDS = 832, RAM_BASE = 0x0400, RAM_WORDS = 832 };
+
+  uint16_t wordAt(uint16_t address) {
+    if (address >= EEPROM_BASE && address < EEPROM_BASE + EEPROM_WORDS) return _eeprom[address - EEPROM_BASE];
+    if (address >= RAM_BASE && address < RAM_BASE + RAM_WORDS) return 0x0100 + (address & 0xFF);
+    if (address == 0x8000) return 0x0009; // new data ready, subpage 1
+    if (address == 0x800D) return _control;
+    return 0;
+  }
+
+  uint16_t _eeprom[EEPROM_WORDS];
+  uint16_t _pointer;
+  uint16_t _control;
+};
+
+// Status byte then 20-bit humidity and temperature; reads return the last
+// measurement until a new one is triggered (0xAC)
+class AHT20Sim : public I2CSimDevice {
+public:
+  void write(const uint8_t* data, size_t len) override {}
+
+  void read(uint8_t* data, size_t len) override {
+    static const uint8_t measurement[7] = { 0x18, 0x66, 0x66, 0x55, 0xE6, 0x66, 0x2F };
+    for (size_t i = 0; i < len; i++) data[i] = i < sizeof(measurement) ? measurement[i] : 0xFF;
+  }
+};
+
+// Byte-addressed registers
+class BMP280Sim : public I2CSimDevice {
+public:
+  BMP280Sim() : _pointer(0) {
+    // Datasheet example trimming parameters
+    static const uint8_t calibration[24] = {
+      0x70, 0x6B, 0x43, 0x67, 0x18, 0xFC, 0x7D, 0x8E, 0x43, 0xD6, 0xD0, 0x0B,
+      0x27, 0x0B, 0x8C, 0x00, 0xF9, 0xFF, 0x8C, 0x3C, 0xF8, 0xC6, 0x70, 0x17
+    };
+    memset(_regs, 0, sizeof(_regs));
+    memcpy(&_regs[0x88], calibration, sizeof(calibration));
+    _regs[0xD0] = 0x58;
+  }
+
+  void write(const uint8_t* data, size_t len) override {
+    if (len >= 1) _pointer = data[0];
+    for (size_t i = 1; i < len; i++) _regs[(uint8_t)(_pointer + i - 1)] = data[i];
+  }
+
+  void read(uint8_t* data, size_t len) override {
+    for (size_t i = 0; i < len; i++) data[i] = _regs[_pointer++];
+  }
+
+private:
+  uint8_t _regs[256];
+  uint8_t _pointer;
+};
+
+static MLX90640Sim mlx90640;
+static AHT20Sim aht20;
+static BMP280Sim bmp280;
+
+static I2CSimDevice* deviceAt(uint8_t address) {
+  switch (address) {
+    case 0x33: return &mlx90640;
+    case 0x38: return &aht20;
+    case 0x76: return &bmp280;
+    default: return nullptr;
+  }
+}
+
+// -------------------------------------------------------------------
+// TwoWire
+// -------------------------------------------------------------------
+
+TwoWire::TwoWire() : _clock(100000), _txAddress(0), _txLength(0), _rxLength(0), _rxIndex(0) {}
+
+bool TwoWire::begin(int sda, int scl, uint32_t frequency) {
+  if (frequency) _clock = frequency;
+  return true;
+}
+
+bool TwoWire::setClock(uint32_t frequency) {
+  _clock = frequency ? frequency : 100000;
+  return true;
+}
+
+void TwoWire::busTime(size_t bytes) {
+  sim::counters.i2cBytes += bytes;
+  sim::advanceMicros((uint64_t)bytes * 9 * 1000000 / _clock);
+}
+
+void TwoWire::beginTransmission(uint8_t address) {
+  _txAddress = address;
+  _txLength = 0;
+}
+
+size_t TwoWire::write(uint8_t data) {
+  if (_txLength >= I2C_BUFFER_LENGTH) return 0;
+  _txBuffer[_txLength++] = data;
+  return 1;
+}
+
+size_t TwoWire::write(const uint8_t* data, size_t len) {
+  size_t n = 0;
+  while (n < len && write(data[n])) n++;
+  return n;
+}
+
+// 0 = success, 2 = address NACK (same codes as the ESP32 core)
+uint8_t TwoWire::endTransmission(bool sendStop) {
+  sim::Overhead overhead;
+  I2CSimDevice* device = deviceAt(_txAddress);
+  busTime(device ? _txLength + 1 : 1);
+  if (!device) return 2;
+  device->write(_txBuffer, _txLength);
+  _txLength = 0;
+  return 0;
+}
+
+size_t TwoWire::requestFrom(uint8_t address, size_t len, bool sendStop) {
+  sim::Overhead overhead;
+  _rxIndex = _rxLength = 0;
+  I2CSimDevice* device = deviceAt(address);
+  if (len > I2C_BUFFER_LENGTH) len = I2C_BUFFER_LENGTH;
+  busTime(device ? len + 1 : 1);
+  if (!device) return 0;
+  device->read(_rxBuffer, len);
+  _rxLength = len;
+  return len;
+}
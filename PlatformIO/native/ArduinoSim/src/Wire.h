@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Arduino.h"
+
+#define I2C_BUFFER_LENGTH 128
+
+// One simulated part on the bus: a register pointer set by writes and
+// auto-incrementing reads
+class I2CSimDevice {
+public:
+  virtual ~I2CSimDevice() {}
+  virtual void write(const uint8_t* data, size_t len) = 0;
+  virtual void read(uint8_t* data, size_t len) = 0;
+};
+
+// TwoWire on the host with the parts the projects talk to:
+//   0x33  MLX90640 (16-bit registers: EEPROM from 0x2400, RAM from 0x0400,
+//         status 0x8000, control 0x800D)
+//   0x38  AHT20 (status command 0x71, 7-byte measurement)
+//   0x76  BMP280 (chip ID 0xD0 = 0x58, calibration from 0x88)
+// Every byte, address included, costs 9 bit times of virtual time at the
+// current clock.
+class TwoWire : public Stream {
+public:
+  TwoWire();
+
+  bool begin() { return true; }
+  bool begin(int sda, int scl, uint32_t frequency = 0);
+  bool end() { return true; }
+  bool setClock(uint32_t frequency);
+  uint32_t getClock() const { return _clock; }
+  void setTimeOut(uint16_t timeOutMillis) {}
+
+  void beginTransmission(uint8_t address);
+  void beginTransmission(int address) { beginTransmission((uint8_t)address); }
+  uint8_t endTransmission(bool sendStop = true);
+
+  size_t requestFrom(uint8_t address, size_t len, bool sendStop);
+  uint8_t requestFrom(uint8_t address, uint8_t len) { return requestFrom(address, (size_t)len, true); }
+  uint8_t requestFrom(uint8_t address, uint8_t len, uint8_t sendStop) { return requestFrom(address, (size_t)len, (bool)sendStop); }
+  uint8_t requestFrom(int address, int len) { return requestFrom((uint8_t)address, (size_t)len, true); }
+  uint8_t requestFrom(int address, int len, int sendStop) { return requestFrom((uint8_t)address, (size_t)len, (bool)sendStop); }
+
+  size_t write(uint8_t data) override;
+  size_t write(const uint8_t* data, size_t len) override;
+  using Print::write;
+  int available() override { return _rxLength - _rxIndex; }
+  int read() override { return _rxIndex < _rxLength ? _rxBuffer[_rxIndex++] : -1; }
+  int peek() override { return _rxIndex < _rxLength ? _rxBuffer[_rxIndex] : -1; }
+  void flush() override {}
+
+private:
+  void busTime(size_t bytes);
+
+  uint32_t _clock;
+  uint8_t _txAddress;
+  uint8_t _txBuffer[I2C_BUFFER_LENGTH];
+  size_t _txLength;
+  uint8_t _rxBuffer[I2C_BUFFER_LENGTH];
+  size_t _rxLength;
+  size_t _rxIndex;
+};
+
+extern TwoWire Wire;
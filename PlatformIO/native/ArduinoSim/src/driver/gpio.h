@@ -0,0 +1,13 @@
+#pragma once
+
+#include "esp_err.h"
+
+typedef enum {
+  GPIO_NUM_NC = -1,
+  GPIO_NUM_0 = 0,
+  GPIO_NUM_MAX = 49,
+} gpio_num_t;
+
+// Share the pin table behind digitalWrite()/digitalRead()
+esp_err_t gpio_set_level(gpio_num_t gpio, uint32_t level);
+int gpio_get_level(gpio_num_t gpio);
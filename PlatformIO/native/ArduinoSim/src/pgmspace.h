@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+// Flash and RAM are the same address space on the host
+
+#define PROGMEM
+#define PGM_P const char*
+#define PSTR(s) (s)
+
+#define pgm_read_byte(addr)    (*(const unsigned char*)(addr))
+#define pgm_read_word(addr)    (*(const uint16_t*)(addr))
+#define pgm_read_dword(addr)   (*(const uint32_t*)(addr))
+#define pgm_read_float(addr)   (*(const float*)(addr))
+#define pgm_read_ptr(addr)     (*(void* const*)(addr))
+#define pgm_read_pointer(addr) (*(void* const*)(addr))
+
+#define strlen_P(s)        strlen(s)
+#define strcmp_P(a, b)     strcmp((a), (b))
+#define strncmp_P(a, b, n) strncmp((a), (b), (n))
+#define strcpy_P(d, s)     strcpy((d), (s))
+#define strncpy_P(d, s, n) strncpy((d), (s), (n))
+#define memcpy_P(d, s, n)  memcpy((d), (s), (n))
+#define memcmp_P(a, b, n)  memcmp((a), (b), (n))
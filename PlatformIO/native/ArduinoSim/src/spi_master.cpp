@@ -0,0 +1,117 @@
+#include "driver/spi_master.h"
+#include "Sim.h"
+
+#include <string.h>
+
+#define MAX_DEVICES 3
+#define MAX_QUEUE   64
+
+struct spi_device_t {
+  spi_device_interface_config_t config;
+  spi_transaction_t* done[MAX_QUEUE]; // completed, waiting for get_trans_result()
+  uint8_t doneHead;
+  uint8_t doneCount;
+  bool used;
+};
+
+static spi_device_t devices[MAX_DEVICES];
+static bool busInitialized = false;
+
+esp_err_t spi_bus_initialize(spi_host_device_t host, const spi_bus_config_t* config, int dma_chan) {
+  if (busInitialized) return ESP_ERR_INVALID_STATE;
+  busInitialized = true;
+  return ESP_OK;
+}
+
+esp_err_t spi_bus_free(spi_host_device_t host) {
+  busInitialized = false;
+  return ESP_OK;
+}
+
+esp_err_t spi_bus_add_device(spi_host_device_t host, const spi_device_interface_config_t* config,
+                             spi_device_handle_t* handle) {
+  if (!busInitialized) return ESP_ERR_INVALID_STATE;
+  for (int i = 0; i < MAX_DEVICES; i++) {
+    if (devices[i].used) continue;
+    memset(&devices[i], 0, sizeof(devices[i]));
+    devices[i].config = *config;
+    devices[i].used = true;
+    *handle = &devices[i];
+    return ESP_OK;
+  }
+  return ESP_ERR_NO_MEM;
+}
+
+esp_err_t spi_bus_remove_device(spi_device_handle_t handle) {
+  handle->used = false;
+  return ESP_OK;
+}
+
+// Puts one transaction on the "wire"
+static void execute(spi_device_handle_t handle, spi_transaction_t* t) {
+  sim::Overhead overhead;
+  size_t len = (t->length + 7) / 8;
+  const uint8_t* tx = (t->flags & SPI_TRANS_USE_TXDATA) ? t->tx_data : (const uint8_t*)t->tx_buffer;
+  uint8_t* rx = (t->flags & SPI_TRANS_USE_RXDATA) ? t->rx_data : (uint8_t*)t->rx_buffer;
+
+  sim::counters.spiBytes += len;
+  sim::counters.spiTransfers++;
+
+  if (handle->config.pre_cb) {
+    handle->config.pre_cb(t);
+    if (tx) {
+      if (sim::lastGpioLevel()) {
+        sim::panelData(tx, len);
+      } else {
+        for (size_t i = 0; i < len; i++) sim::panelCommand(tx[i]);
+      }
+    }
+  } else if (tx) {
+    sim::touchTransfer(tx, rx, len);
+  }
+
+  if (handle->config.post_cb) handle->config.post_cb(t);
+}
+
+esp_err_t spi_device_queue_trans(spi_device_handle_t handle, spi_transaction_t* trans, uint32_t ticks) {
+  int depth = handle->config.queue_size < MAX_QUEUE ? handle->config.queue_size : MAX_QUEUE;
+  if (handle->doneCount >= depth) return ESP_ERR_TIMEOUT;
+
+  execute(handle, trans);
+  handle->done[(handle->doneHead + handle->doneCount) % MAX_QUEUE] = trans;
+  handle->doneCount++;
+  return ESP_OK;
+}
+
+esp_err_t spi_device_get_trans_result(spi_device_handle_t handle, spi_transaction_t** trans, uint32_t ticks) {
+  if (!handle->doneCount) return ESP_ERR_TIMEOUT;
+  *trans = handle->done[handle->doneHead];
+  handle->doneHead = (handle->doneHead + 1) % MAX_QUEUE;
+  handle->doneCount--;
+  return ESP_OK;
+}
+
+esp_err_t spi_device_transmit(spi_device_handle_t handle, spi_transaction_t* trans) {
+  execute(handle, trans);
+  return ESP_OK;
+}
+
+esp_err_t spi_device_polling_transmit(spi_device_handle_t handle, spi_transaction_t* trans) {
+  execute(handle, trans);
+  return ESP_OK;
+}
+
+esp_err_t spi_device_polling_start(spi_device_handle_t handle, spi_transaction_t* trans, uint32_t ticks) {
+  execute(handle, trans);
+  return ESP_OK;
+}
+
+esp_err_t spi_device_polling_end(spi_device_handle_t handle, uint32_t ticks) {
+  return ESP_OK;
+}
+
+esp_err_t spi_device_acquire_bus(spi_device_handle_t handle, uint32_t wait) {
+  return ESP_OK;
+}
+
+void spi_device_release_bus(spi_device_handle_t handle) {}
@@ -0,0 +1,48 @@
+#include <Adafruit_GFX.h>
+#include <TFTDisplay.h>    // Shared DMA display driver (pins in TFTPins.h)
+
+// A screen of status text redrawn every frame, the way the projects draw
+// their overlays: opaque 1x text, transparent 2x text, and a few lines and
+// circles. Glyphs, diagonal lines and circles all reach the driver one
+// writePixel() at a time.
+
+TFTDisplay tft;
+uint32_t frameCount = 0;
+
+void setup() {
+  tft.begin();
+  tft.setRotation(1); // Landscape mode
+  tft.fillScreen(ILI9341_BLACK);
+}
+
+void loop() {
+  char text[64];
+
+  // 1. Opaque small text: every glyph cell is rewritten
+  tft.setTextSize(1);
+  tft.setTextColor(ILI9341_WHITE, ILI9341_BLACK);
+  for (int16_t row = 0; row < 16; row++) {
+    snprintf(text, sizeof(text), "%2d frame %6lu  %8lu ms  ABCDEFGHIJKLMNOP", row,
+             (unsigned long)frameCount, (unsigned long)millis());
+    tft.setCursor(0, row * 10);
+    tft.print(text);
+  }
+
+  // 2. Transparent large text over a cleared band
+  tft.fillRect(0, 170, tft.width(), 40, ILI9341_NAVY);
+  tft.setTextSize(2);
+  tft.setTextColor(ILI9341_YELLOW);
+  snprintf(text, sizeof(text), "Frame %lu", (unsigned long)frameCount);
+  tft.setCursor(10, 182);
+  tft.print(text);
+
+  // 3. Lines and circles
+  int16_t phase = frameCount % 40;
+  tft.fillRect(0, 212, tft.width(), 28, ILI9341_BLACK);
+  for (int16_t i = 0; i < 8; i++) {
+    tft.drawLine(i * 40 + phase / 4, 214, i * 40 + 30, 238, ILI9341_GREEN);
+    tft.drawCircle(i * 40 + 20, 226, 6 + (phase + i) % 6, ILI9341_RED);
+  }
+
+  frameCount++;
+}
@@ -0,0 +1,49 @@
+#!/bin/sh
+# Builds every project's native env (plus native/TextBench, a GFX text
+# workload) and runs its loop benchmark.
+#
+#   tools/bench_all.sh            print each project's per-frame table
+#   tools/bench_all.sh --save     also record bench/<project>.txt baselines
+#   tools/bench_all.sh --check    compare against those baselines, exit 1 on
+#                                 any regression
+#
+# Anything after "--" goes to every benchmark (e.g. -- --frames 1000).
+
+cd "$(dirname "$0")/.." || exit 2
+
+mode=run
+case "$1" in
+  --save)  mode=save;  shift ;;
+  --check) mode=check; shift ;;
+esac
+[ "$1" = "--" ] && shift
+
+mkdir -p bench
+status=0
+
+for project in Projects/*/ native/TextBench/; do
+  project=${project%/}
+  name=$(basename "$project" | tr ' ' '_')
+  baseline="bench/$name.txt"
+
+  if ! pio run -d "$project" -e native -s; then
+    echo "$name: build failed" >&2
+    status=1
+    continue
+  fi
+
+  program="$project/.pio/build/native/program"
+  case $mode in
+    run)   "$program" --name "$name" "$@" ;;
+    save)  "$program" --name "$name" "$@" --save "$baseline" ;;
+    check) if [ -f "$baseline" ]; then
+             "$program" --name "$name" "$@" --baseline "$baseline"
+           else
+             echo "$name: no baseline, run with --save first" >&2
+             false
+           fi ;;
+  esac || status=1
+  echo
+done
+
+exit $status
@@ -0,0 +1,278 @@
+#!/usr/bin/env python3
+"""Watch one or more IR cameras streaming with lib/IRStream.
+
+Connects to each camera, rebuilds every frame from the keyframes and deltas,
+and reports per camera: frame rate, throughput, message sizes, frames the
+server skipped for us, and end-to-end latency (capture on the camera to
+decoded here). Latency uses the camera's clock through a PING/PONG offset
+estimate, so it works across machines as well as over loopback.
+
+    python irstream_client.py 192.168.1.50 192.168.1.51     # two cameras
+    python irstream_client.py 127.0.0.1:40123 --duration 10 # native-stream build
+    python irstream_client.py cam.local --record frames.csv # replayable
+
+--record writes one CSV line of 768 temperatures per frame, the format
+native/ArduinoSim replays through MLX90640_REPLAY.
+"""
+
+import argparse
+import selectors
+import socket
+import struct
+import sys
+import time
+
+SYNC = b"\xa5\x5c"
+VERSION = 1
+HEADER = 6  # sync(2) type(1) flags(1) payload length(2)
+
+HELLO, KEYFRAME, DELTA, PONG, PING = 0x01, 0x02, 0x03, 0x04, 0x10
+FLAG_WIDE = 0x01
+DEFAULT_PORT = 5050
+RECEIVE_BUFFER = 8192
+
+
+def now_us():
+    return time.monotonic_ns() // 1000
+
+
+def wrap32(v):
+    """Signed difference of two 32-bit microsecond stamps."""
+    v &= 0xFFFFFFFF
+    return v - (1 << 32) if v & 0x80000000 else v
+
+
+def percentile(values, p):
+    if not values:
+        return 0
+    v = sorted(values)
+    return v[min(len(v) - 1, int(p / 100.0 * (len(v) - 1) + 0.5))]
+
+
+class Camera:
+    def __init__(self, host, port, record):
+        self.name = "%s:%d" % (host, port)
+        self.address = (host, port)
+        self.record = record
+        self.sock = None
+        self.buf = bytearray()
+        self.width = self.height = 0
+        self.step = 0.1
+        self.frame = None
+        self.last_seq = None
+        self.last_ping = 0
+        self.pongs = []  # (rtt, offset) of recent round trips
+        self.offset = None
+        self.reset_window()
+        self.totals = {"frames": 0, "bytes": 0, "missed": 0}
+        self.all_sizes = {KEYFRAME: [], DELTA: []}
+        self.all_latency = []
+
+    def reset_window(self):
+        self.window_start = time.monotonic()
+        self.frames = 0
+        self.bytes = 0
+        self.missed = 0
+        self.sizes = {KEYFRAME: [], DELTA: []}
+        self.latency = []
+
+    # --- connection ---
+
+    def connect(self, timeout):
+        deadline = time.monotonic() + timeout
+        while True:
+            self.sock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+            # A viewer wants the newest frame, not a backlog: keep the
+            # receive window small so the camera skips frames instead
+            self.sock.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, RECEIVE_BUFFER)
+            self.sock.settimeout(1)
+            try:
+                self.sock.connect(self.address)
+                break
+            except OSError:
+                self.sock.close()
+                if time.monotonic() > deadline:
+                    raise
+                time.sleep(0.2)
+        self.sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        self.sock.setblocking(False)
+
+    def ping(self):
+        token = now_us() & 0xFFFFFFFF
+        msg = SYNC + struct.pack("<BBHI", PING, 0, 4, token)
+        try:
+            self.sock.send(msg)
+        except BlockingIOError:
+            pass
+        self.last_ping = time.monotonic()
+
+    # --- decoding ---
+
+    def feed(self, data):
+        self.buf += data
+        while True:
+            start = self.buf.find(SYNC)
+            if start < 0:
+                del self.buf[:-1]
+                return
+            del self.buf[:start]
+            if len(self.buf) < HEADER:
+                return
+            kind, flags, length = struct.unpack_from("<BBH", self.buf, 2)
+            if len(self.buf) < HEADER + length:
+                return
+            payload = bytes(self.buf[HEADER:HEADER + length])
+            del self.buf[:HEADER + length]
+            self.handle(kind, flags, payload, HEADER + length)
+
+    def handle(self, kind, flags, payload, size):
+        self.bytes += size
+        self.totals["bytes"] += size
+        if kind == HELLO:
+            version, self.width, self.height, _, step_mc = struct.unpack_from("<BBBBH", payload)
+            if version != VERSION:
+                sys.exit("%s: protocol version %d, expected %d" % (self.name, version, VERSION))
+            self.step = step_mc / 1000.0
+        elif kind == PONG:
+            token, server_us = struct.unpack_from("<II", payload)
+            t1 = now_us()
+            rtt = wrap32(t1 - token)
+            # Server clock minus ours, assuming the PONG was stamped mid-way
+            offset = wrap32(server_us - (token + rtt // 2))
+            self.pongs = (self.pongs + [(rtt, offset)])[-16:]
+            self.offset = min(self.pongs)[1]  # the fastest round trip is the most accurate
+        elif kind in (KEYFRAME, DELTA):
+            seq, capture_us = struct.unpack_from("<II", payload)
+            if kind == KEYFRAME:
+                self.decode_keyframe(flags, payload)
+            elif self.frame is None:
+                return  # cannot happen on a fresh connection; be safe
+            else:
+                self.decode_delta(payload)
+            self.frame_done(kind, seq, capture_us, size)
+
+    def decode_keyframe(self, flags, payload):
+        (base,) = struct.unpack_from("<h", payload, 8)
+        n = self.width * self.height
+        if flags & FLAG_WIDE:
+            values = struct.unpack_from("<%dH" % n, payload, 10)
+        else:
+            values = payload[10:10 + n]
+        self.frame = [base + v for v in values]
+
+    def decode_delta(self, payload):
+        n = self.width * self.height
+        bitmap = payload[8:8 + n // 8]
+        pos = 8 + n // 8
+        changed = [i for i in range(n) if bitmap[i >> 3] >> (i & 7) & 1]
+        codes = payload[pos:pos + (len(changed) + 1) // 2]
+        escapes = pos + len(codes)
+        for k, i in enumerate(changed):
+            code = codes[k >> 1] >> 4 if k & 1 else codes[k >> 1] & 0x0F
+            if code == 15:
+                (self.frame[i],) = struct.unpack_from("<h", payload, escapes)
+                escapes += 2
+            else:
+                self.frame[i] += code - 7
+
+    def frame_done(self, kind, seq, capture_us, size):
+        if self.last_seq is not None and seq - self.last_seq > 1:
+            self.missed += seq - self.last_seq - 1
+            self.totals["missed"] += seq - self.last_seq - 1
+        self.last_seq = seq
+        self.frames += 1
+        self.totals["frames"] += 1
+        self.sizes[kind].append(size)
+        self.all_sizes[kind].append(size)
+        if self.offset is not None:
+            latency = wrap32(now_us() - (capture_us - self.offset)) / 1000.0
+            self.latency.append(latency)
+            self.all_latency.append(latency)
+        if self.record:
+            self.record.write(",".join("%.2f" % (v * self.step) for v in self.frame) + "\n")
+
+    # --- reporting ---
+
+    def report(self, seconds, frames, nbytes, missed, sizes, latency):
+        def avg(v):
+            return sum(v) / len(v) if v else 0
+        line = "%-21s %6.1f fps %8.1f KB/s  key %4d x %5.0f B  delta %5d x %5.0f B  missed %5d" % (
+            self.name, frames / seconds if seconds else 0, nbytes / 1024.0 / seconds if seconds else 0,
+            len(sizes[KEYFRAME]), avg(sizes[KEYFRAME]), len(sizes[DELTA]), avg(sizes[DELTA]), missed)
+        if latency:
+            line += "  latency ms mean %.2f p50 %.2f p99 %.2f max %.2f" % (
+                avg(latency), percentile(latency, 50), percentile(latency, 99), max(latency))
+        print(line)
+
+    def report_window(self):
+        seconds = time.monotonic() - self.window_start
+        self.report(seconds, self.frames, self.bytes, self.missed, self.sizes, self.latency)
+        self.reset_window()
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    ap.add_argument("cameras", nargs="+", help="host or host:port (default port %d)" % DEFAULT_PORT)
+    ap.add_argument("--duration", type=float, help="stop after this many seconds")
+    ap.add_argument("--interval", type=float, default=2.0, help="seconds between reports")
+    ap.add_argument("--ping", type=float, default=0.5, help="seconds between clock-offset pings")
+    ap.add_argument("--read-delay", type=float, default=0,
+                    help="ms to sleep after each read, to play a slow viewer")
+    ap.add_argument("--record", help="append every frame of the first camera to this CSV file")
+    ap.add_argument("--connect-timeout", type=float, default=5.0)
+    args = ap.parse_args()
+
+    record = open(args.record, "a") if args.record else None
+    cameras = []
+    for i, spec in enumerate(args.cameras):
+        host, _, port = spec.partition(":")
+        cameras.append(Camera(host, int(port) if port else DEFAULT_PORT, record if i == 0 else None))
+
+    sel = selectors.DefaultSelector()
+    for cam in cameras:
+        cam.connect(args.connect_timeout)
+        sel.register(cam.sock, selectors.EVENT_READ, cam)
+        cam.ping()
+
+    start = last_report = time.monotonic()
+    try:
+        while sel.get_map():
+            now = time.monotonic()
+            if args.duration and now - start >= args.duration:
+                break
+            for key, _ in sel.select(timeout=0.05):
+                cam = key.data
+                try:
+                    data = cam.sock.recv(65536)
+                except BlockingIOError:
+                    continue
+                except OSError:
+                    data = b""
+                if not data:
+                    print("%s: connection closed" % cam.name)
+                    sel.unregister(cam.sock)
+                    continue
+                cam.feed(data)
+                if args.read_delay:
+                    time.sleep(args.read_delay / 1000.0)
+            for cam in cameras:
+                if now - cam.last_ping >= args.ping:
+                    cam.ping()
+            if now - last_report >= args.interval:
+                for cam in cameras:
+                    cam.report_window()
+                last_report = now
+    except KeyboardInterrupt:
+        pass
+
+    seconds = time.monotonic() - start
+    print("\nTotal over %.1f s" % seconds)
+    for cam in cameras:
+        cam.report(seconds, cam.totals["frames"], cam.totals["bytes"], cam.totals["missed"], cam.all_sizes,
+                   cam.all_latency)
+    if record:
+        record.close()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,217 @@
+#!/usr/bin/env python3
+"""Decode the binary stage-timing records written by lib/Telemetry.
+
+Reads a serial port (or a capture file, or stdin with "-"), picks the framed
+records out of whatever text the sketch also prints, and shows per-stage
+latency percentiles and throughput for every export window.
+
+    python telemetry_decode.py /dev/ttyACM0            # live, 115200 baud
+    python telemetry_decode.py capture.bin --total     # whole capture at once
+
+Serial ports need pyserial (pip install pyserial).
+"""
+
+import argparse
+import struct
+import sys
+
+SYNC = b"\xa5\x5a"
+VERSION = 1
+HEADER = 6  # sync(2) version(1) stages(1) payload length(2)
+
+
+def crc16(data):
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else crc << 1
+            crc &= 0xFFFF
+    return crc
+
+
+def bucket_range(b):
+    """[low, high) cycle range of a histogram bucket (see bucketOf())."""
+    if b < 4:
+        return b, b + 1
+    e = (b >> 2) + 1
+    sub = b & 3
+    return (4 + sub) << (e - 2), (5 + sub) << (e - 2)
+
+
+class Reader:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def u8(self):
+        v = self.data[self.pos]
+        self.pos += 1
+        return v
+
+    def unpack(self, fmt):
+        v = struct.unpack_from(fmt, self.data, self.pos)
+        self.pos += struct.calcsize(fmt)
+        return v
+
+    def varint(self):
+        v = shift = 0
+        while True:
+            b = self.u8()
+            v |= (b & 0x7F) << shift
+            shift += 7
+            if not b & 0x80:
+                return v
+
+
+class Stage:
+    def __init__(self, name):
+        self.name = name
+        self.count = 0
+        self.sum = 0
+        self.min = None
+        self.max = 0
+        self.buckets = {}
+
+    def merge(self, other):
+        if not other.count:
+            return
+        self.count += other.count
+        self.sum += other.sum
+        self.min = other.min if self.min is None else min(self.min, other.min)
+        self.max = max(self.max, other.max)
+        for b, n in other.buckets.items():
+            self.buckets[b] = self.buckets.get(b, 0) + n
+
+    def percentile(self, p):
+        """Cycles at percentile p, interpolated inside the bucket and clamped to min/max."""
+        total = sum(self.buckets.values())
+        if not total:
+            return 0
+        rank = p / 100.0 * total
+        seen = 0
+        for b in sorted(self.buckets):
+            n = self.buckets[b]
+            if seen + n >= rank:
+                low, high = bucket_range(b)
+                v = low + (high - low) * (rank - seen) / n
+                return max(self.min, min(self.max, v))
+            seen += n
+        return self.max
+
+
+def parse_record(payload, stage_count):
+    r = Reader(payload)
+    timestamp, window, mhz = r.unpack("<IIH")
+    stages = []
+    for _ in range(stage_count):
+        n = r.u8()
+        name = payload[r.pos:r.pos + n].decode("ascii", "replace")
+        r.pos += n
+        s = Stage(name)
+        s.count = r.varint()
+        s.sum = r.varint()
+        s.min = r.varint()
+        s.max = r.varint()
+        for _ in range(r.u8()):
+            b = r.u8()
+            s.buckets[b] = r.varint()
+        stages.append(s)
+    return timestamp, window, mhz, stages
+
+
+def records(chunks):
+    """Yield (timestamp, window, mhz, stages) for every valid record in a byte stream."""
+    buf = bytearray()
+    for chunk in chunks:
+        buf += chunk
+        while True:
+            start = buf.find(SYNC)
+            if start < 0:
+                del buf[:-1]  # keep a trailing A5 in case the 5A is still in flight
+                break
+            del buf[:start]
+            if len(buf) < HEADER:
+                break
+            version, stage_count, length = struct.unpack_from("<BBH", buf, 2)
+            if version != VERSION:
+                del buf[:2]
+                continue
+            end = HEADER + length + 2
+            if len(buf) < end:
+                break
+            payload = bytes(buf[HEADER:HEADER + length])
+            (crc,) = struct.unpack_from("<H", buf, HEADER + length)
+            if crc != crc16(payload):
+                del buf[:2]  # sync bytes were part of log text; look further on
+                continue
+            del buf[:end]
+            try:
+                yield parse_record(payload, stage_count)
+            except (IndexError, struct.error):
+                continue
+
+
+def print_table(title, window_ms, mhz, stages):
+    seconds = window_ms / 1000.0 if window_ms else 0
+    print(title)
+    print("  %-15s %8s %9s %10s %10s %10s %10s %7s" %
+          ("stage", "count", "per sec", "mean us", "p50 us", "p99 us", "max us", "busy"))
+    for s in stages:
+        if not s.count:
+            print("  %-15s %8d" % (s.name, 0))
+            continue
+        us = lambda cycles: cycles / float(mhz)
+        rate = s.count / seconds if seconds else 0
+        busy = us(s.sum) / (seconds * 1e6) * 100 if seconds else 0
+        print("  %-15s %8d %9.1f %10.1f %10.1f %10.1f %10.1f %6.1f%%" %
+              (s.name, s.count, rate, us(s.sum / s.count), us(s.percentile(50)),
+               us(s.percentile(99)), us(s.max), busy))
+    print()
+
+
+def open_source(path, baud):
+    if path == "-":
+        src = sys.stdin.buffer
+        return iter(lambda: src.read1(4096), b"")
+    if path.startswith(("/dev/", "COM")):
+        import serial  # pyserial
+        port = serial.Serial(path, baud, timeout=0.2)
+        return iter(lambda: port.read(4096), None)
+    f = open(path, "rb")
+    return iter(lambda: f.read(65536), b"")
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    ap.add_argument("source", help="serial port, capture file, or - for stdin")
+    ap.add_argument("--baud", type=int, default=115200)
+    ap.add_argument("--total", action="store_true",
+                    help="only print the aggregate over all windows at the end")
+    args = ap.parse_args()
+
+    totals = {}
+    order = []
+    total_ms = 0
+    mhz = 240
+    try:
+        for timestamp, window, mhz, stages in records(open_source(args.source, args.baud)):
+            total_ms += window
+            for s in stages:
+                if s.name not in totals:
+                    totals[s.name] = Stage(s.name)
+                    order.append(s.name)
+                totals[s.name].merge(s)
+            if not args.total:
+                print_table("t=%.1fs  window %d ms  @%d MHz" % (timestamp / 1000.0, window, mhz),
+                            window, mhz, stages)
+    except KeyboardInterrupt:
+        pass
+
+    if order:
+        print_table("Total over %.1f s" % (total_ms / 1000.0), total_ms, mhz,
+                    [totals[n] for n in order])
+
+
+if __name__ == "__main__":
+    main()